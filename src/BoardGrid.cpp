@@ -4,44 +4,66 @@ void BoardGrid::initilization(int w, int h, int l) {
     this->w = w;
     this->h = h;
     this->l = l;
-    this->size = w * h * l;
-
-    assert(this->grid == nullptr);
-    this->grid = new GridCell[this->size];
-    assert(this->grid != nullptr);
-
-    this->base_cost_fill(0.0);
-    // this->via_cost_fill(0.0);
+    this->setupCellLayout();
+    this->setupCostQuantum();
+
+    // Each cell field lives in its own plane, so the searches only stream the fields they touch
+    this->allocatePlane(this->mBaseCostPlane, this->encodeCost(0.0));
+    this->allocatePlane(this->mCachedTraceCostPlane, this->encodeCachedCost(-1.0));
+    this->allocatePlane(this->mCachedViaCostPlane, this->encodeCachedCost(-1.0));
+    // Stamp 0 never matches an epoch, so every cached cost starts as uncached
+    this->allocatePlane(this->mNetStampPlane, (std::uint16_t)0);
+    // Flags are independent bits, a cell can be both a targeted pin and via forbidden
+    this->mViaForbiddenBits.allocate(this->w, this->h, this->l);
+    this->mTargetedPinBits.allocate(this->w, this->h, this->l);
+    this->mNetEpoch = 1;
+    this->mTargetDistanceMap.clear();
+    this->mLandmarkTables.clear();
+}
+
+void BoardGrid::resetNetScratch() {
+    ++this->mNetEpoch;
+    if (this->mNetEpoch == 0) {
+        // Wrapped around, old stamps may match again
+        this->mNetStampPlane.fill(0);
+        this->mNetEpoch = 1;
+    }
 }
 
-void BoardGrid::base_cost_fill(float value) {
+void BoardGrid::materializeNetScratch() {
     for (int i = 0; i < this->size; ++i) {
-        this->grid[i].baseCost = value;
+        this->touchNetScratch(i);
     }
 }
 
+void BoardGrid::base_cost_fill(float value) {
+    this->mBaseCostPlane.fill(this->encodeCost(value));
+    // Counted again by the next setupJumpTiles(), built again by the next net
+    this->mJumpTileCounts.clear();
+    this->mTargetDistanceMap.clear();
+    this->mLandmarkTables.clear();
+}
+
 void BoardGrid::working_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].workingCost = value;
+    for (int i = 0; i < this->mSearchWindow.numCells(); ++i) {
+        this->mSearchWindow.setWorkingCost(i, pr::toCost(value));
     }
 }
 
 void BoardGrid::bending_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].bendingCost = value;
+    for (int i = 0; i < this->mSearchWindow.numCells(); ++i) {
+        this->mSearchWindow.setBendingCost(i, pr::toCost(value));
     }
 }
 
 void BoardGrid::cached_trace_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].cachedTraceCost = value;
-    }
+    this->materializeNetScratch();
+    this->mCachedTraceCostPlane.fill(this->encodeCachedCost(value));
 }
 
 void BoardGrid::cached_via_cost_fill(float value) {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].cachedViaCost = value;
-    }
+    this->materializeNetScratch();
+    this->mCachedViaCostPlane.fill(this->encodeCachedCost(value));
 }
 
 // void BoardGrid::via_cost_fill(float value) {
@@ -53,173 +75,458 @@ void BoardGrid::cached_via_cost_fill(float value) {
 
 float BoardGrid::base_cost_at(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost;
+    return this->decodeCost(this->mBaseCostPlane[this->locationToId(l)]);
 }
 
 float BoardGrid::via_cost_at(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    //return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaCost;
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost;
+    return this->decodeCost(this->mBaseCostPlane[this->locationToId(l)]);
 }
 
 float BoardGrid::working_cost_at(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].workingCost;
+    if (!this->mSearchWindow.contains(l)) {
+        return std::numeric_limits<float>::infinity();
+    }
+    const pr::prCost cost = this->mSearchWindow.workingCost(this->mSearchWindow.id(l));
+    return cost == pr::kCostInfinity ? std::numeric_limits<float>::infinity() : pr::fromCost(cost);
 }
 
 float BoardGrid::bending_cost_at(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].bendingCost;
+    if (!this->mSearchWindow.contains(l)) {
+        return 0.0;
+    }
+    return pr::fromCost(this->mSearchWindow.bendingCost(this->mSearchWindow.id(l)));
 }
 
 float BoardGrid::cached_trace_cost_at(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedTraceCost;
+    int id = this->locationToId(l);
+    if (this->mNetStampPlane[id] != this->mNetEpoch) {
+        return -1.0;
+    }
+    return this->decodeCachedCost(this->mCachedTraceCostPlane[id]);
 }
 
 float BoardGrid::cached_via_cost_at(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert((l.m_x + l.m_y * this->w + l.m_z * this->w * this->h) < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedViaCost;
+    int id = this->locationToId(l);
+    if (this->mNetStampPlane[id] != this->mNetEpoch) {
+        return -1.0;
+    }
+    return this->decodeCachedCost(this->mCachedViaCostPlane[id]);
 }
 
 void BoardGrid::base_cost_set(float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost = value;
+    this->setBaseCost(l, this->encodeCost(value));
 }
 
 void BoardGrid::base_cost_add(float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost += value;
+    this->addBaseCost(l, value);
 }
 
 void BoardGrid::base_cost_add(float value, const Location &l, const std::vector<Point_2D<int>> &shapeToGrids) {
     for (const auto &relativePt : shapeToGrids) {
+        Location current_l{l.m_x + relativePt.x(), l.m_y + relativePt.y(), l.m_z};
 #ifdef BOUND_CHECKS
-        assert(((l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (l.m_z) * this->w * this->h) < this->size);
+        assert(this->locationToId(current_l) < this->size);
 #endif
-        this->grid[(l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (l.m_z) * this->w * this->h].baseCost += value;
+        this->addBaseCost(current_l, value);
     }
 }
 
 void BoardGrid::working_cost_set(float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].workingCost = value;
+    assert(this->mSearchWindow.contains(l));
+    this->mSearchWindow.setWorkingCost(this->mSearchWindow.id(l), pr::toCost(value));
 }
 
 void BoardGrid::bending_cost_set(float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].bendingCost = value;
+    assert(this->mSearchWindow.contains(l));
+    this->mSearchWindow.setBendingCost(this->mSearchWindow.id(l), pr::toCost(value));
 }
 
 void BoardGrid::cached_trace_cost_set(float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedTraceCost = value;
+    int id = this->locationToId(l);
+    this->touchNetScratch(id);
+    this->mCachedTraceCostPlane[id] = this->encodeCachedCost(value);
 }
 
 void BoardGrid::cached_via_cost_set(float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cachedViaCost = value;
+    int id = this->locationToId(l);
+    this->touchNetScratch(id);
+    this->mCachedViaCostPlane[id] = this->encodeCachedCost(value);
 }
 
-void BoardGrid::setCameFromId(const Location &l, const int id) {
+void BoardGrid::setCameFrom(const Location &l, const Location &prev) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cameFromId = id;
+    assert(this->mSearchWindow.contains(l));
+    this->mSearchWindow.setCameFrom(this->mSearchWindow.id(l), SearchWindow::cameFromCode(l, prev));
 }
 
-int BoardGrid::getCameFromId(const Location &l) const {
+std::uint8_t BoardGrid::getCameFrom(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cameFromId;
+    if (!this->mSearchWindow.contains(l)) {
+        return CAME_FROM_NONE;
+    }
+    return this->mSearchWindow.cameFrom(this->mSearchWindow.id(l));
 }
 
-int BoardGrid::getCameFromId(const int id) const {
-#ifdef BOUND_CHECKS
-    assert(id < this->size);
-#endif
-    return this->grid[id].cameFromId;
+void BoardGrid::clearAllCameFrom() {
+    for (int i = 0; i < this->mSearchWindow.numCells(); ++i) {
+        this->mSearchWindow.setCameFrom(i, CAME_FROM_NONE);
+    }
 }
 
-void BoardGrid::clearAllCameFromId() {
-    for (int i = 0; i < this->size; ++i) {
-        this->grid[i].cameFromId = -1;
+void BoardGrid::setupSearchWindow(const MultipinRoute &route, const int margin) {
+    if (margin < 0) {
+        this->setupFullSearchWindow();
+        return;
+    }
+    int minX = this->w, maxX = -1, minY = this->h, maxY = -1;
+    auto expand = [&](const Location &l) {
+        minX = std::min(minX, l.m_x);
+        maxX = std::max(maxX, l.m_x);
+        minY = std::min(minY, l.m_y);
+        maxY = std::max(maxY, l.m_y);
+    };
+    // Sources, same as initializeFrontiers()
+    if (route.getGridPaths().empty()) {
+        for (const auto &pt : route.mGridPins.front().pinWithLayers) {
+            expand(pt);
+        }
+    } else {
+        for (const auto &gp : route.getGridPaths()) {
+            for (const auto &pt : gp.getLocations()) {
+                expand(pt);
+            }
+        }
+    }
+    for (const auto &pt : this->currentTargetedPinWithLayers) {
+        expand(pt);
+    }
+    if (maxX < 0) {
+        this->setupFullSearchWindow();
+        return;
+    }
+    this->mSearchWindow.setup(std::max(minX - margin, 0), std::min(maxX + margin, this->w - 1),
+                              std::max(minY - margin, 0), std::min(maxY + margin, this->h - 1), this->l);
+    this->adviseSearchWindow();
+}
+
+void BoardGrid::setupNetSearchWindow(const MultipinRoute &route, const int margin) {
+    if (margin < 0) {
+        this->setupFullSearchWindow();
+        return;
+    }
+    int minX = this->w, maxX = -1, minY = this->h, maxY = -1;
+    auto expand = [&](const Location &l) {
+        minX = std::min(minX, l.m_x);
+        maxX = std::max(maxX, l.m_x);
+        minY = std::min(minY, l.m_y);
+        maxY = std::max(maxY, l.m_y);
+    };
+    for (const auto &pin : route.mGridPins) {
+        for (const auto &pt : pin.pinWithLayers) {
+            expand(pt);
+        }
+    }
+    // Paths found in grown windows may leave the pins' bounding box
+    for (const auto &gp : route.getGridPaths()) {
+        for (const auto &pt : gp.getLocations()) {
+            expand(pt);
+        }
+    }
+    if (maxX < 0) {
+        this->setupFullSearchWindow();
+        return;
+    }
+    this->mSearchWindow.setup(std::max(minX - margin, 0), std::min(maxX + margin, this->w - 1),
+                              std::max(minY - margin, 0), std::min(maxY + margin, this->h - 1), this->l);
+    this->adviseSearchWindow();
+}
+
+void BoardGrid::adviseSearchWindow() const {
+    if (!this->mBaseCostPlane.fileBacked() || this->mCellLayout == CellLayout::ROW_MAJOR) {
+        return;
+    }
+    // Each row of tiles of the window is a contiguous id range, per layer or for all layers if interleaved
+    const bool interleaved = this->mCellLayout == CellLayout::TILED_LAYER_INTERLEAVED;
+    const int tileCells = 1 << (2 * this->mTileShift);
+    const int firstTileX = this->mSearchWindow.minX() >> this->mTileShift;
+    const int lastTileX = this->mSearchWindow.maxX() >> this->mTileShift;
+    for (int z = 0; z < (interleaved ? 1 : this->l); ++z) {
+        for (int tileY = this->mSearchWindow.minY() >> this->mTileShift; tileY <= this->mSearchWindow.maxY() >> this->mTileShift; ++tileY) {
+            int firstTile = tileY * this->mNumTilesX + firstTileX;
+            int lastTile = tileY * this->mNumTilesX + lastTileX;
+            int beginId = interleaved ? firstTile * this->l * tileCells : (z * this->mNumTilesPerLayer + firstTile) * tileCells;
+            int endId = interleaved ? (lastTile + 1) * this->l * tileCells : (z * this->mNumTilesPerLayer + lastTile + 1) * tileCells;
+            this->mBaseCostPlane.adviseWillNeed(beginId, endId);
+            this->mCachedTraceCostPlane.adviseWillNeed(beginId, endId);
+            this->mCachedViaCostPlane.adviseWillNeed(beginId, endId);
+            this->mNetStampPlane.adviseWillNeed(beginId, endId);
+        }
+    }
+}
+
+void BoardGrid::setupFullSearchWindow() {
+    this->mSearchWindow.setup(0, this->w - 1, 0, this->h - 1, this->l);
+}
+
+void BoardGrid::setSearchCorridor(const std::vector<std::uint8_t> &gcells, const int gcellSize) {
+    assert(gcellSize > 0);
+    if (gcellSize != this->mCorridorGCellSize || (int)this->mCorridorColumn.size() != this->w || (int)this->mCorridorRowOffset.size() != this->h) {
+        const int gcellsPerRow = (this->w - 1) / gcellSize + 1;
+        this->mCorridorColumn.resize(this->w);
+        for (int x = 0; x < this->w; ++x) {
+            this->mCorridorColumn[x] = x / gcellSize;
+        }
+        this->mCorridorRowOffset.resize(this->h);
+        for (int y = 0; y < this->h; ++y) {
+            this->mCorridorRowOffset[y] = y / gcellSize * gcellsPerRow;
+        }
+        this->mCorridorGCellSize = gcellSize;
+    }
+    assert(gcells.size() == (std::size_t)(((this->w - 1) / gcellSize + 1) * ((this->h - 1) / gcellSize + 1)));
+    this->mSearchCorridor = gcells;
+    this->mUseSearchCorridor = true;
+}
+
+bool BoardGrid::searchWindowCoversBoard() const {
+    return this->mSearchWindow.minX() == 0 && this->mSearchWindow.minY() == 0 &&
+           this->mSearchWindow.maxX() == this->w - 1 && this->mSearchWindow.maxY() == this->h - 1;
+}
+
+void BoardGrid::setupCellLayout() {
+    int tileSize = 1;
+    this->mTileShift = 0;
+    this->mSparse = GlobalParam::gGridSparse;
+    // Sparse planes allocate per tile and file-backed planes page per tile, so both need a tiled layout
+    const bool needsTiles = this->mSparse || !GlobalParam::gGridMmapDirectory.empty();
+    const int requestedTileSize = (needsTiles && GlobalParam::gGridTileSize == 0) ? 16 : (int)GlobalParam::gGridTileSize;
+    while (tileSize < requestedTileSize) {
+        tileSize <<= 1;
+        ++this->mTileShift;
+    }
+
+    if (this->mTileShift == 0) {
+        this->mCellLayout = CellLayout::ROW_MAJOR;
+        this->size = this->w * this->h * this->l;
+    } else {
+        this->mCellLayout = GlobalParam::gGridTileLayerInterleave ? CellLayout::TILED_LAYER_INTERLEAVED : CellLayout::TILED;
+        this->mTileMask = tileSize - 1;
+        this->mNumTilesX = (this->w + tileSize - 1) >> this->mTileShift;
+        this->mNumTilesPerLayer = this->mNumTilesX * ((this->h + tileSize - 1) >> this->mTileShift);
+        // Partial tiles on the right/top edges are padded
+        this->size = this->mNumTilesPerLayer * this->l << (2 * this->mTileShift);
+    }
+    std::cout << __FUNCTION__ << "(): tile size: " << tileSize << ", layer interleaved: " << (this->mCellLayout == CellLayout::TILED_LAYER_INTERLEAVED) << ", sparse: " << this->mSparse
+              << ", #cells: " << this->size << " (" << this->w * this->h * this->l << " on board)" << std::endl;
+}
+
+void BoardGrid::showMemoryUsage() const {
+    std::size_t bytes = this->mBaseCostPlane.allocatedBytes() + this->mCachedTraceCostPlane.allocatedBytes() + this->mCachedViaCostPlane.allocatedBytes() +
+                        this->mNetStampPlane.allocatedBytes() + this->mViaForbiddenBits.allocatedBytes() + this->mTargetedPinBits.allocatedBytes();
+    std::size_t denseBytes = (std::size_t)this->size * (sizeof(pr::prStoredCost) * 3 + sizeof(std::uint16_t)) +
+                             this->mViaForbiddenBits.allocatedBytes() + this->mTargetedPinBits.allocatedBytes();
+    std::cout << "BoardGrid memory: " << bytes / 1048576.0 << " MB (dense: " << denseBytes / 1048576.0 << " MB)"
+              << ", file-backed: " << GridAllocator::mappedBytes() / 1048576.0 << " MB"
+              << ", search window buffers: " << (this->mSearchWindow.allocatedBytes() + this->mBackwardSearchWindow.allocatedBytes()) / 1048576.0 << " MB"
+              << ", frontier: " << (this->mFrontier.allocatedBytes() + this->mBucketFrontier.allocatedBytes() + this->mBackwardFrontier.allocatedBytes()) / 1048576.0
+              << " MB, target distance map: " << this->mTargetDistanceMap.allocatedBytes() / 1048576.0
+              << " MB, landmark tables: " << this->mLandmarkTables.allocatedBytes() / 1048576.0 << " MB" << std::endl;
+    GridAllocator::showPolicy();
+}
+
+std::size_t BoardGrid::estimateMemoryBytes(const int w, const int h, const int l) {
+    // Padded the same way as setupCellLayout(), sparse planes are counted as dense
+    const bool needsTiles = GlobalParam::gGridSparse || !GlobalParam::gGridMmapDirectory.empty();
+    const int requestedTileSize = (needsTiles && GlobalParam::gGridTileSize == 0) ? 16 : (int)GlobalParam::gGridTileSize;
+    std::size_t tileSize = 1;
+    while ((int)tileSize < requestedTileSize) {
+        tileSize <<= 1;
     }
+    const std::size_t paddedW = (w + tileSize - 1) / tileSize * tileSize;
+    const std::size_t paddedH = (h + tileSize - 1) / tileSize * tileSize;
+    const std::size_t numCells = paddedW * paddedH * l;
+    const std::size_t planeBytes = numCells * (sizeof(pr::prStoredCost) * 3 + sizeof(std::uint16_t));
+    const std::size_t bitBytes = 2 * sizeof(std::uint64_t) * ((w + 63) / 64) * h * l;
+    // The search window grows up to the whole board when no path is found in it, the frontier keeps a position per window cell
+    std::size_t searchBytes = (std::size_t)w * h * l * (sizeof(float) + sizeof(int) + sizeof(std::uint8_t) + sizeof(std::uint16_t) + sizeof(std::uint32_t));
+    if (GlobalParam::gBidirectionalSearch) {
+        searchBytes *= 2;
+    }
+    if (GlobalParam::gBucketFrontier) {
+        searchBytes += (std::size_t)w * h * l * (sizeof(float) + sizeof(std::uint32_t) + sizeof(std::uint8_t));
+    }
+    return planeBytes + bitBytes + searchBytes;
+}
+
+void BoardGrid::startConnectionStats() {
+    this->mConnectionStats = SearchStats();
+    this->mConnectionStart = SearchStats();
+    this->mConnectionStart.numPushes = this->mFrontier.numPushes() + this->mBucketFrontier.numPushes() + this->mBackwardFrontier.numPushes();
+    this->mConnectionStart.numStalePops = this->mFrontier.numStalePops() + this->mBucketFrontier.numStalePops() + this->mBackwardFrontier.numStalePops();
+    this->mConnectionStart.numViaCacheHits = this->viaCachedHit;
+    this->mConnectionStart.numViaCacheMisses = this->viaCachedMissed;
+    this->mFrontier.resetPeakSize();
+    this->mBucketFrontier.resetPeakSize();
+    this->mBackwardFrontier.resetPeakSize();
+    this->mConnectionStartTime = std::chrono::steady_clock::now();
+}
+
+void BoardGrid::finishConnectionStats(MultipinRoute &route, const bool found) {
+    SearchStats &stats = this->mConnectionStats;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->mConnectionStartTime).count();
+    stats.numConnections = 1;
+    stats.numCappedConnections = !found && this->expansionLimitReached() ? 1 : 0;
+    // Frontier and via cache counters are over all the searches
+    stats.numPushes = this->mFrontier.numPushes() + this->mBucketFrontier.numPushes() + this->mBackwardFrontier.numPushes() - this->mConnectionStart.numPushes;
+    stats.numStalePops = this->mFrontier.numStalePops() + this->mBucketFrontier.numStalePops() + this->mBackwardFrontier.numStalePops() - this->mConnectionStart.numStalePops;
+    stats.numViaCacheHits = this->viaCachedHit - this->mConnectionStart.numViaCacheHits;
+    stats.numViaCacheMisses = this->viaCachedMissed - this->mConnectionStart.numViaCacheMisses;
+    // Bidirectional searches hold both frontiers at once
+    stats.peakFrontierSize = std::max(this->mFrontier.peakSize() + this->mBackwardFrontier.peakSize(), this->mBucketFrontier.peakSize());
+    route.mSearchStats.add(stats);
+}
+
+void BoardGrid::showFrontierQoR() const {
+    if (this->mNumQoRChecks == 0) {
+        return;
+    }
+    std::cout << "Bucket queue (resolution " << GlobalParam::gBucketFrontierResolution << ") vs. exact ordering: " << this->mNumQoRChecks << " searches, "
+              << this->mNumQoRWorse << " worse, total cost delta: " << this->mQoRCostDelta << ", max delta: " << this->mQoRMaxCostDelta << std::endl;
+}
+
+void BoardGrid::setupCostQuantum() {
+#ifdef PCBROUTER_QUANTIZED_COST
+    // Resolution: the quantum is gTraceBasicCost scaled by a power of two, so trace (and usually
+    // via/pad) obstacle costs are exact multiples of it. It is the finest such value that still
+    // represents costCeiling, i.e. 16 stacked pad obstacles (gPinObstacleCost), without saturation.
+    // Defaults (50, 1000) give a quantum of 0.78125 and a ceiling of ~25600 per cell.
+    const double costCeiling = 16.0 * std::max(std::fabs(GlobalParam::gPinObstacleCost), std::fabs(GlobalParam::gTraceBasicCost));
+    const double maxUnits = std::numeric_limits<pr::prStoredCost>::max();
+    double quantum = GlobalParam::gTraceBasicCost > 0.0 ? GlobalParam::gTraceBasicCost : 1.0;
+    while (costCeiling / quantum > maxUnits) {
+        quantum *= 2.0;
+    }
+    while (costCeiling / (quantum / 2.0) <= maxUnits) {
+        quantum /= 2.0;
+    }
+    this->mCostQuantum = quantum;
+    std::cout << __FUNCTION__ << "(): 16-bit cost storage, quantum: " << this->mCostQuantum
+              << ", max cost: " << this->mCostQuantum * maxUnits << std::endl;
+#elif defined(PCBROUTER_FIXED_POINT_COST)
+    this->mCostQuantum = pr::fromCost(1);
+    std::cout << __FUNCTION__ << "(): fixed point cost storage, quantum: " << this->mCostQuantum
+              << ", max cost: " << pr::fromCost(pr::kCostInfinity) << std::endl;
+#else
+    this->mCostQuantum = 1.0;
+#endif
 }
 
 int BoardGrid::locationToId(const Location &l) const {
-    return l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    if (this->mCellLayout == CellLayout::ROW_MAJOR) {
+        return l.m_x + l.m_y * this->w + l.m_z * this->w * this->h;
+    }
+    int tileId = (l.m_y >> this->mTileShift) * this->mNumTilesX + (l.m_x >> this->mTileShift);
+    int inTileId = ((l.m_y & this->mTileMask) << this->mTileShift) + (l.m_x & this->mTileMask);
+    if (this->mCellLayout == CellLayout::TILED_LAYER_INTERLEAVED) {
+        return ((tileId * this->l + l.m_z) << (2 * this->mTileShift)) + inTileId;
+    }
+    return ((l.m_z * this->mNumTilesPerLayer + tileId) << (2 * this->mTileShift)) + inTileId;
 }
 
 void BoardGrid::idToLocation(const int id, Location &l) const {
-    l.m_z = id / (this->w * this->h);
-    l.m_y = (id - l.m_z * this->w * this->h) / this->w;
-    l.m_x = (id - l.m_z * this->w * this->h) % this->w;
+    if (this->mCellLayout == CellLayout::ROW_MAJOR) {
+        l.m_z = id / (this->w * this->h);
+        l.m_y = (id - l.m_z * this->w * this->h) / this->w;
+        l.m_x = (id - l.m_z * this->w * this->h) % this->w;
+        return;
+    }
+    int inTileId = id & ((1 << (2 * this->mTileShift)) - 1);
+    int tileAndLayer = id >> (2 * this->mTileShift);
+    int tileId = 0;
+    if (this->mCellLayout == CellLayout::TILED_LAYER_INTERLEAVED) {
+        tileId = tileAndLayer / this->l;
+        l.m_z = tileAndLayer - tileId * this->l;
+    } else {
+        l.m_z = tileAndLayer / this->mNumTilesPerLayer;
+        tileId = tileAndLayer - l.m_z * this->mNumTilesPerLayer;
+    }
+    int tileY = tileId / this->mNumTilesX;
+    int tileX = tileId - tileY * this->mNumTilesX;
+    l.m_x = (tileX << this->mTileShift) + (inTileId & this->mTileMask);
+    l.m_y = (tileY << this->mTileShift) + (inTileId >> this->mTileShift);
 }
 
 void BoardGrid::via_cost_set(const float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaCost = value;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost = value;
+    this->setBaseCost(l, this->encodeCost(value));
 }
 
 void BoardGrid::via_cost_add(const float value, const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaCost += value;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].baseCost += value;
+    this->addBaseCost(l, value);
 }
 
 void BoardGrid::setTargetedPin(const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].targetedPin = true;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::TARGET_PIN;
+    this->mTargetedPinBits.set(l.m_x, l.m_y, l.m_z);
 }
 
 void BoardGrid::clearTargetedPin(const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    //this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].targetedPin = false;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::VACANT;
+    this->mTargetedPinBits.clear(l.m_x, l.m_y, l.m_z);
 }
 
-bool BoardGrid::isTargetedPin(const Location &l) {
+bool BoardGrid::isTargetedPin(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    //return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].targetedPin;
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType == GridCellType::TARGET_PIN;
+    return this->mTargetedPinBits.test(l.m_x, l.m_y, l.m_z);
 }
 
 void BoardGrid::setTargetedPins(const std::vector<Location> &pins) {
@@ -235,26 +542,23 @@ void BoardGrid::clearTargetedPins(const std::vector<Location> &pins) {
 
 void BoardGrid::setViaForbidden(const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    // this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaForbidden = true;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::VIA_FORBIDDEN;
+    this->mViaForbiddenBits.set(l.m_x, l.m_y, l.m_z);
 }
 
 void BoardGrid::clearViaForbidden(const Location &l) {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    // this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaForbidden = false;
-    this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType = GridCellType::VACANT;
+    this->mViaForbiddenBits.clear(l.m_x, l.m_y, l.m_z);
 }
 
 bool BoardGrid::isViaForbidden(const Location &l) const {
 #ifdef BOUND_CHECKS
-    assert(l.m_x + l.m_y * this->w + l.m_z * this->w * this->h < this->size);
+    assert(this->locationToId(l) < this->size);
 #endif
-    // return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].viaForbidden;
-    return this->grid[l.m_x + l.m_y * this->w + l.m_z * this->w * this->h].cellType == GridCellType::VIA_FORBIDDEN;
+    return this->mViaForbiddenBits.test(l.m_x, l.m_y, l.m_z);
 }
 
 void BoardGrid::setViaForbiddenArea(const std::vector<Location> &locations) {
@@ -398,15 +702,23 @@ void BoardGrid::clearViaForbiddenArea(const std::vector<Location> &locations) {
 // }
 
 void BoardGrid::aStarWithGridCameFrom(const std::vector<Location> &route, Location &finalEnd, float &finalCost) {
+    dispatchSearchMode(GlobalParam::gUseMircoVia, !GlobalParam::g90DegreeMode, GlobalParam::gBendingAwareSearch, [&](auto mode) {
+        this->aStarWithGridCameFromInMode<decltype(mode)>(route, finalEnd, finalCost);
+        return true;
+    });
+}
+
+template <typename Mode>
+void BoardGrid::aStarWithGridCameFromInMode(const std::vector<Location> &route, Location &finalEnd, float &finalCost) {
     std::cout << __FUNCTION__ << "() nets: route.features.size() = " << route.size() << std::endl;
 
     // For path to multiple points
     // Searches from the multiple points to every other point
-    this->working_cost_fill(std::numeric_limits<float>::infinity());
-    this->bending_cost_fill(0);
+    this->setupFullSearchWindow();
 
-    float bestCostWhenReachTarget = std::numeric_limits<float>::max();
-    LocationQueue<Location, float> frontier;  // search frontier
+    pr::prCost bestCostWhenReachTarget = pr::kCostInfinity;
+    FrontierHeap &frontier = this->mFrontier;  // search frontier
+    frontier.reset(this->mSearchWindow.numCells());
     this->initializeFrontiers(route, frontier);
 
     std::cout << " frontier.size(): " << frontier.size() << ", current targeted pin:  " << std::endl;
@@ -417,7 +729,8 @@ void BoardGrid::aStarWithGridCameFrom(const std::vector<Location> &route, Locati
     // int numPopLocation = 0;
 
     while (!frontier.empty()) {
-        Location current = frontier.front();
+        Location current;
+        this->mSearchWindow.idToLocation(frontier.frontId(), current);
 
         // // Debugging
         // numPopLocation++;
@@ -430,60 +743,126 @@ void BoardGrid::aStarWithGridCameFrom(const std::vector<Location> &route, Locati
         if (isTargetedPin(current)) {
             bestCostWhenReachTarget = frontier.frontKey();
             finalEnd = current;
-            finalCost = bestCostWhenReachTarget;
-            std::cout << "=> Find the target: " << current << " with cost at " << bestCostWhenReachTarget << std::endl;
+            finalCost = pr::fromCost(bestCostWhenReachTarget);
+            std::cout << "=> Find the target: " << current << " with cost at " << finalCost << std::endl;
             return;
         }
 
+        const int currentWindowId = frontier.frontId();
         frontier.pop();
 
-        std::vector<std::pair<float, Location>> neighbors;
-        this->getNeighbors(current, neighbors);
-        float current_cost = this->working_cost_at(current);
+        const pr::prCost current_cost = this->mSearchWindow.workingCost(currentWindowId);
+        this->forEachNeighbor<Mode>(current, this->mSearchWindow.cameFrom(currentWindowId), [&](const Location &next, const int nextId, const pr::prCost stepCost) {
+            const int nextWindowId = this->mSearchWindow.id(next);
+            pr::prCost new_cost = pr::addCost(current_cost, stepCost);  // Can be optimized!!!!
 
-        for (std::pair<float, Location> &next : neighbors) {
-            float new_cost = current_cost + next.first;  // Can be optimized!!!!
-
-            //float estCost = getEstimatedCost(next.second);
-            // Test bending cost
-            float estCost = getEstimatedCostWithBendingCost(current, next.second);
-            int bendCost = getBendingCostOfNext(current, next.second);
+            float estCost = getEstimatedCostOfNext<Mode>(this->mSearchWindow.cameFrom(currentWindowId), current, next, this->current_targeted_pin) + targetDistanceCost(next);
+            pr::prCost bendCost = Mode::kBendingAware ? pr::toCost(getBendingCostOfNext(current, next)) : 0;
 
             // Test bending cost + multi-layers (3D estimation cost)
-            // float estCost = getEstimatedCostWithLayersAndBendingCost(current, next.second);
+            // float estCost = getEstimatedCostWithLayersAndBendingCost(current, next);
 
-            if (new_cost + bendCost < this->working_cost_at(next.second) + this->bending_cost_at(next.second)) {
-                //if () {
-                this->working_cost_set(new_cost, next.second);
-                this->bending_cost_set(bendCost, next.second);
-                this->setCameFromId(next.second, this->locationToId(current));
+            if (pr::addCost(new_cost, bendCost) < pr::addCost(this->mSearchWindow.workingCost(nextWindowId), this->mSearchWindow.bendingCost(nextWindowId))) {
+                this->mSearchWindow.setWorkingCost(nextWindowId, new_cost);
+                this->mSearchWindow.setBendingCost(nextWindowId, bendCost);
+                this->mSearchWindow.setCameFrom(nextWindowId, SearchWindow::cameFromCode(next, current));
 
-                frontier.push(next.second, new_cost + estCost + bendCost);
+                frontier.push(nextWindowId, pr::addCost(pr::addCost(new_cost, pr::toCost(estCost)), bendCost));
 
                 // float keyValue = new_cost + estCost + bendCost;
-                // std::cout << "Better Cost at Location " << next.second << ", with Cost: " << new_cost << ", est Cost: " << estCost << ", bend Cost: " << bendCost << ", key value: " << keyValue << std::endl;
+                // std::cout << "Better Cost at Location " << next << ", with Cost: " << new_cost << ", est Cost: " << estCost << ", bend Cost: " << bendCost << ", key value: " << keyValue << std::endl;
 
                 // Show if the target is reached
-                if (isTargetedPin(next.second)) {
-                    std::cout << "Find target with estCost = " << estCost << ", walkedCost = " << new_cost << ", bend Cost: " << bendCost
-                              << ", currentLoc: " << current << ", nextLoc: " << next.second << std::endl;
+                if (isTargetedPin(next)) {
+                    std::cout << "Find target with estCost = " << estCost << ", walkedCost = " << pr::fromCost(new_cost) << ", bend Cost: " << pr::fromCost(bendCost)
+                              << ", currentLoc: " << current << ", nextLoc: " << next << std::endl;
                 }
             }
-        }
+        });
     }
     //For Dijkstra to output
-    finalCost = bestCostWhenReachTarget;
-    std::cout << "=> Find the target with cost at " << bestCostWhenReachTarget << std::endl;
+    finalCost = pr::fromCost(bestCostWhenReachTarget);
+    std::cout << "=> Find the target with cost at " << finalCost << std::endl;
 }
 
-void BoardGrid::aStarSearching(MultipinRoute &route, Location &finalEnd, float &finalCost) {
-    std::cout << __FUNCTION__ << "() nets: route.mGridPaths.size() = " << route.mGridPaths.size() << std::endl;
+bool BoardGrid::aStarSearching(MultipinRoute &route, Location &finalEnd, float &finalCost) {
+    if (!GlobalParam::gBucketFrontier) {
+        return this->aStarSearchingWithFrontier(route, this->mFrontier, finalEnd, finalCost);
+    }
+    this->mBucketFrontier.setResolution(GlobalParam::gBucketFrontierResolution);
+    if (!GlobalParam::gBucketFrontierQoRCheck) {
+        return this->aStarSearchingWithFrontier(route, this->mBucketFrontier, finalEnd, finalCost);
+    }
 
-    this->working_cost_fill(std::numeric_limits<float>::infinity());
-    this->bending_cost_fill(0);
+    // Exact ordering first, the bucket queue search then overwrites the search window for backtracking.
+    // Only the search whose path is kept counts in the connection statistics and the expansion limit.
+    const SearchStats connectionStats = this->mConnectionStats;
+    const long long numPushes = this->mFrontier.numPushes();
+    const long long numStalePops = this->mFrontier.numStalePops();
+    const long long numViaCacheHits = this->viaCachedHit;
+    const long long numViaCacheMisses = this->viaCachedMissed;
+    const auto exactStartTime = std::chrono::steady_clock::now();
+    Location exactEnd;
+    float exactCost = 0.0;
+    const bool exactFound = this->aStarSearchingWithFrontier(route, this->mFrontier, exactEnd, exactCost);
+    this->mConnectionStats = connectionStats;
+    this->mConnectionStart.numPushes += this->mFrontier.numPushes() - numPushes;
+    this->mConnectionStart.numStalePops += this->mFrontier.numStalePops() - numStalePops;
+    this->mConnectionStart.numViaCacheHits += this->viaCachedHit - numViaCacheHits;
+    this->mConnectionStart.numViaCacheMisses += this->viaCachedMissed - numViaCacheMisses;
+    this->mConnectionStartTime += std::chrono::steady_clock::now() - exactStartTime;
+    this->mFrontier.resetPeakSize();
+    const bool found = this->aStarSearchingWithFrontier(route, this->mBucketFrontier, finalEnd, finalCost);
+    if (exactFound && found) {
+        const double delta = (double)finalCost - (double)exactCost;
+        ++this->mNumQoRChecks;
+        this->mQoRCostDelta += delta;
+        this->mQoRMaxCostDelta = std::max(this->mQoRMaxCostDelta, delta);
+        if (delta > GlobalParam::gEpsilon) {
+            ++this->mNumQoRWorse;
+        }
+        std::cout << __FUNCTION__ << "(): bucket queue cost: " << finalCost << ", exact cost: " << exactCost << ", delta: " << delta << std::endl;
+    }
+    return found;
+}
+
+template <typename Frontier>
+bool BoardGrid::aStarSearchingWithFrontier(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) {
+    return dispatchSearchMode(GlobalParam::gUseMircoVia, !GlobalParam::g90DegreeMode, GlobalParam::gBendingAwareSearch, [&](auto mode) {
+        return this->aStarSearchingWithMode<decltype(mode)>(route, frontier, finalEnd, finalCost);
+    });
+}
+
+template <typename Mode, typename Frontier>
+bool BoardGrid::aStarSearchingWithMode(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) {
+    int margin = GlobalParam::gSearchWindowMargin;
+    this->setupSearchWindow(route, margin);
+    bool found = this->aStarSearchingInWindow<Mode>(route, frontier, finalEnd, finalCost);
+    while (!found && !this->expansionLimitReached() && !this->searchWindowCoversBoard()) {
+        // No path inside the window, grow it and search again
+        margin = std::max(2 * margin, 1);
+        std::cout << __FUNCTION__ << "(): no path in the search window, retry with margin " << margin << std::endl;
+        this->setupSearchWindow(route, margin);
+        found = this->aStarSearchingInWindow<Mode>(route, frontier, finalEnd, finalCost);
+    }
+    if (!found && !this->expansionLimitReached() && this->mUseSearchCorridor) {
+        // No path inside the corridor of the global route, search the whole board. The next
+        // connections of the net keep the corridor.
+        std::cout << __FUNCTION__ << "(): no path in the search corridor, retry without it" << std::endl;
+        this->mUseSearchCorridor = false;
+        found = this->aStarSearchingInWindow<Mode>(route, frontier, finalEnd, finalCost);
+        this->mUseSearchCorridor = true;
+    }
+    return found;
+}
 
-    float bestCostWhenReachTarget = std::numeric_limits<float>::max();
-    LocationQueue<Location, float> frontier;  // search frontier
+template <typename Mode, typename Frontier>
+bool BoardGrid::aStarSearchingInWindow(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) {
+    std::cout << __FUNCTION__ << "() nets: route.mGridPaths.size() = " << route.mGridPaths.size()
+              << ", window: (" << this->mSearchWindow.minX() << ", " << this->mSearchWindow.minY() << ") - ("
+              << this->mSearchWindow.maxX() << ", " << this->mSearchWindow.maxY() << ")" << std::endl;
+
+    frontier.reset(this->mSearchWindow.numCells());
 
     // For path to multiple points. Searches from the multiple points to every other point
     this->initializeFrontiers(route, frontier);
@@ -493,55 +872,481 @@ void BoardGrid::aStarSearching(MultipinRoute &route, Location &finalEnd, float &
         std::cout << "  " << pt << std::endl;
     }
 
+    return this->aStarExpandFrontier<Mode>(route, frontier, finalEnd, finalCost);
+}
+
+bool BoardGrid::aStarSearchingIncremental(MultipinRoute &route, Location &finalEnd, float &finalCost) {
+    return dispatchSearchMode(GlobalParam::gUseMircoVia, !GlobalParam::g90DegreeMode, GlobalParam::gBendingAwareSearch, [&](auto mode) {
+        return this->aStarSearchingIncrementalWithMode<decltype(mode)>(route, finalEnd, finalCost);
+    });
+}
+
+template <typename Mode>
+bool BoardGrid::aStarSearchingIncrementalWithMode(MultipinRoute &route, Location &finalEnd, float &finalCost) {
+    FrontierHeap &frontier = this->mFrontier;
+    SearchWindow &window = this->mSearchWindow;
+    if (!this->mIncrementalSearchArmed) {
+        this->setupNetSearchWindow(route, GlobalParam::gSearchWindowMargin);
+        frontier.reset(window.numCells());
+        this->initializeFrontiers(route, frontier);
+    } else {
+        // Adding sources only lowers costs: the cells expanded so far have relaxed all their
+        // neighbours and keep valid costs, the ones still queued and the cells the new path lowers
+        // are all that is left to expand. Only the keys change, as they estimate towards the new target.
+        auto key = [&](const int id) {
+            Location l;
+            window.idToLocation(id, l);
+            const std::uint8_t cameFrom = window.cameFrom(id);
+            float estCost = 0.0;
+            if (cameFrom == CAME_FROM_SOURCE) {
+                estCost = getEstimatedCost<Mode>(l, this->current_targeted_pin) + targetDistanceCost(l);
+            } else {
+                Location prev;
+                SearchWindow::cameFromLocation(l, cameFrom, prev);
+                estCost = getEstimatedCostOfNext<Mode>(window.cameFrom(window.id(prev)), prev, l, this->current_targeted_pin) + targetDistanceCost(l);
+            }
+            return pr::addCost(pr::addCost(window.workingCost(id), pr::toCost(estCost * this->mHeuristicWeight)), window.bendingCost(id));
+        };
+        frontier.rekey(key);
+        this->initializeGridPathToFrontier(route.getGridPaths().back(), frontier);
+        // Targets expanded by the previous searches are not queued anymore
+        for (const auto &pt : this->currentTargetedPinWithLayers) {
+            const int id = window.id(pt);
+            if (window.cameFrom(id) != CAME_FROM_NONE && !frontier.contains(id)) {
+                frontier.push(id, key(id));
+            }
+        }
+    }
+    std::cout << __FUNCTION__ << "() nets: route.mGridPaths.size() = " << route.mGridPaths.size() << ", resumed: " << this->mIncrementalSearchArmed
+              << ", frontier.size(): " << frontier.size() << std::endl;
+
+    bool found = this->aStarExpandFrontier<Mode>(route, frontier, finalEnd, finalCost);
+    this->mIncrementalSearchArmed = found;
+    if (!found && !this->expansionLimitReached()) {
+        // No path in the net's window, search from scratch in growing windows
+        found = this->aStarSearchingWithMode<Mode>(route, frontier, finalEnd, finalCost);
+    }
+    return found;
+}
+
+template <typename Mode, typename Frontier>
+bool BoardGrid::aStarExpandFrontier(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost) {
+    float bestCostWhenReachTarget = std::numeric_limits<float>::max();
+    // Weighted searches expand each cell once, reopening costs more than it saves. Resumed searches
+    // still have to reopen the cells closed for the previous connection.
+    const bool reopenClosed = this->mHeuristicWeight == 1.0f || GlobalParam::gIncrementalSearch;
     while (!frontier.empty()) {
-        Location current = frontier.front();
+        Location current;
+        this->mSearchWindow.idToLocation(frontier.frontId(), current);
 
         // A* termination
         if (isTargetedPin(current)) {
-            bestCostWhenReachTarget = frontier.frontKey();
+            bestCostWhenReachTarget = pr::fromCost(frontier.frontKey());
+            if (this->mHeuristicWeight != 1.0f) {
+                // Same cost as an unweighted search reaching the target by this path
+                const int targetWindowId = frontier.frontId();
+                const float walkedCost = pr::fromCost(pr::addCost(this->mSearchWindow.workingCost(targetWindowId), this->mSearchWindow.bendingCost(targetWindowId)));
+                bestCostWhenReachTarget = walkedCost + (bestCostWhenReachTarget - walkedCost) / this->mHeuristicWeight;
+            }
             finalEnd = current;
             finalCost = bestCostWhenReachTarget;
             std::cout << "=> Find the target: " << current << " with cost at " << bestCostWhenReachTarget << std::endl;
-            return;
+            return true;
+        }
+        if (this->expansionLimitReached()) {
+            std::cout << __FUNCTION__ << "(): expansion limit reached, " << frontier.size() << " cells left in the frontier" << std::endl;
+            return false;
         }
 
+        const int currentWindowId = frontier.frontId();
         frontier.pop();
+        this->mSearchWindow.setExpanded(currentWindowId);
+        ++this->mConnectionStats.numPops;
+
+        const pr::prCost current_cost = this->mSearchWindow.workingCost(currentWindowId);
+        auto relax = [&](const Location &next, const int nextId, const pr::prCost stepCost) {
+            ++this->mConnectionStats.numNeighbors;
+            if (!this->mSearchWindow.contains(next) || !this->inSearchCorridor(next)) {
+                return;
+            }
+            const int nextWindowId = this->mSearchWindow.id(next);
+            // Expanded: closed. Cells reached by a jump are not queued, they stay open.
+            if (!reopenClosed && this->mSearchWindow.isExpanded(nextWindowId)) {
+                return;
+            }
+            pr::prCost new_cost = pr::addCost(current_cost, stepCost);  // Can be optimized!!!!
 
-        std::vector<std::pair<float, Location>> neighbors;
-        this->getNeighbors(current, neighbors);
-        float current_cost = this->working_cost_at(current);
-
-        for (std::pair<float, Location> &next : neighbors) {
-            float new_cost = current_cost + next.first;  // Can be optimized!!!!
-
-            //float estCost = getEstimatedCost(next.second);
-            // Test bending cost
-            float estCost = getEstimatedCostWithBendingCost(current, next.second);
-            int bendCost = getBendingCostOfNext(current, next.second);
-            pr::prIntCost layerPrefCost = getLayerPrefCost(route, next.second);
-            new_cost += layerPrefCost;
+            float estCost = getEstimatedCostOfNext<Mode>(this->mSearchWindow.cameFrom(currentWindowId), current, next, this->current_targeted_pin) + targetDistanceCost(next);
+            estCost *= this->mHeuristicWeight;
+            pr::prCost bendCost = Mode::kBendingAware ? pr::toCost(getBendingCostOfNext(current, next)) : 0;
+            pr::prIntCost layerPrefCost = getLayerPrefCost(route, next);
+            new_cost = pr::addCost(new_cost, pr::toCost(layerPrefCost));
 
             // Test bending cost + multi-layers (3D estimation cost)
-            // float estCost = getEstimatedCostWithLayersAndBendingCost(current, next.second);
+            // float estCost = getEstimatedCostWithLayersAndBendingCost(current, next);
 
-            if (new_cost + bendCost < this->working_cost_at(next.second) + this->bending_cost_at(next.second)) {
-                this->working_cost_set(new_cost, next.second);
-                this->bending_cost_set(bendCost, next.second);
-                this->setCameFromId(next.second, this->locationToId(current));
+            if (pr::addCost(new_cost, bendCost) < pr::addCost(this->mSearchWindow.workingCost(nextWindowId), this->mSearchWindow.bendingCost(nextWindowId))) {
+                this->mSearchWindow.setWorkingCost(nextWindowId, new_cost);
+                this->mSearchWindow.setBendingCost(nextWindowId, bendCost);
+                this->mSearchWindow.setCameFrom(nextWindowId, SearchWindow::cameFromCode(next, current));
 
-                frontier.push(next.second, new_cost + estCost + bendCost);
+                frontier.push(nextWindowId, pr::addCost(pr::addCost(new_cost, pr::toCost(estCost)), bendCost));
 
                 // Show if the target is reached
-                if (isTargetedPin(next.second)) {
-                    std::cout << "Find target with estCost = " << estCost << ", walkedCost = " << new_cost << ", bend Cost: " << bendCost
-                              << ", currentLoc: " << current << ", nextLoc: " << next.second << std::endl;
+                if (isTargetedPin(next)) {
+                    std::cout << "Find target with estCost = " << estCost << ", walkedCost = " << pr::fromCost(new_cost) << ", bend Cost: " << pr::fromCost(bendCost)
+                              << ", currentLoc: " << current << ", nextLoc: " << next << std::endl;
+                }
+            }
+        };
+        if (this->mUseJumps && this->isOpenCell(current) && !this->onSearchWindowEdge(current)) {
+            // Uniform zero cost around, the planar moves jump over the open cells
+            this->forEachLayerNeighbor<Mode>(current, this->mSearchWindow.cameFrom(currentWindowId), relax);
+            this->aStarJumpFrom<Mode>(route, frontier, current, currentWindowId, reopenClosed);
+        } else {
+            this->forEachNeighbor<Mode>(current, this->mSearchWindow.cameFrom(currentWindowId), relax);
+        }
+    }
+    return false;
+}
+
+template <typename Mode, typename Frontier>
+void BoardGrid::aStarJumpFrom(MultipinRoute &route, Frontier &frontier, const Location &current, const int currentWindowId, const bool reopenClosed) {
+    // Pruned directions: an open cell entered by a planar step only continues it, or its two
+    // components after a diagonal step. Other turns are reached from other cells at no higher
+    // wirelength. 90-degree searches turn at the cells their straight jumps land on.
+    int directions[8][2];
+    int numDirections = 0;
+    auto addDirection = [&](const int dx, const int dy) {
+        directions[numDirections][0] = dx;
+        directions[numDirections][1] = dy;
+        ++numDirections;
+    };
+    const std::uint8_t currentCameFrom = this->mSearchWindow.cameFrom(currentWindowId);
+    if (currentCameFrom >= CAME_FROM_PLANAR && currentCameFrom < CAME_FROM_LAYER) {
+        Location prev;
+        SearchWindow::cameFromLocation(current, currentCameFrom, prev);
+        const int dx = current.m_x - prev.m_x;
+        const int dy = current.m_y - prev.m_y;
+        addDirection(dx, dy);
+        if (dx != 0 && dy != 0) {
+            addDirection(dx, 0);
+            addDirection(0, dy);
+        } else if (!Mode::kDiagonal) {
+            addDirection(dy, dx);
+            addDirection(-dy, -dx);
+        }
+    } else {
+        addDirection(-1, 0);
+        addDirection(1, 0);
+        addDirection(0, 1);
+        addDirection(0, -1);
+        if (Mode::kDiagonal) {
+            addDirection(-1, 1);
+            addDirection(-1, -1);
+            addDirection(1, 1);
+            addDirection(1, -1);
+        }
+    }
+
+    const auto &traceRelativeSearchGrids = mGridNetclasses.at(currentGridNetclassId).getTraceSearchingSpaceToGrids();
+    const pr::prCost layerPrefCost = pr::toCost(getLayerPrefCost(route, current));
+    for (int i = 0; i < numDirections; ++i) {
+        const int dx = directions[i][0];
+        const int dy = directions[i][1];
+        Location landing;
+        int steps = 0;
+        if (!this->jump<Mode>(current, dx, dy, landing, steps)) continue;
+
+        // The cells before the landing one have no trace cost. A cell of the run reached at no higher
+        // cost keeps its path, the run goes on from it.
+        const double stepCost = (dx != 0 && dy != 0) ? GlobalParam::gDiagonalCost : 1.0;
+        const pr::prCost openStepCost = pr::toCost(stepCost);
+        Location prev = current;
+        int prevWindowId = currentWindowId;
+        bool prevOnRun = false;  // Set by the run, which goes straight through it
+        this->mConnectionStats.numNeighbors += steps;
+        for (int step = 1; step <= steps; ++step) {
+            const Location next{current.m_x + step * dx, current.m_y + step * dy, current.m_z};
+            const int nextWindowId = this->mSearchWindow.id(next);
+            const bool isLanding = step == steps;
+            // A closed cell keeps its path, the run goes on from it
+            const bool closed = !reopenClosed && this->mSearchWindow.isExpanded(nextWindowId);
+            if (isLanding && closed) {
+                break;
+            }
+            pr::prCost new_cost = pr::addCost(this->mSearchWindow.workingCost(prevWindowId), layerPrefCost);
+            new_cost = pr::addCost(new_cost, isLanding ? this->traceStepCost(next, this->locationToId(next), stepCost, traceRelativeSearchGrids) : openStepCost);
+            pr::prCost bendCost = 0;
+            if (Mode::kBendingAware) {
+                bendCost = prevOnRun ? this->mSearchWindow.bendingCost(prevWindowId) : pr::toCost(getBendingCostOfNext(prev, next));
+            }
+
+            prevOnRun = !closed && pr::addCost(new_cost, bendCost) < pr::addCost(this->mSearchWindow.workingCost(nextWindowId), this->mSearchWindow.bendingCost(nextWindowId));
+            if (prevOnRun) {
+                const std::uint8_t prevCameFrom = this->mSearchWindow.cameFrom(prevWindowId);
+                this->mSearchWindow.setWorkingCost(nextWindowId, new_cost);
+                this->mSearchWindow.setBendingCost(nextWindowId, bendCost);
+                this->mSearchWindow.setCameFrom(nextWindowId, SearchWindow::cameFromCode(next, prev));
+                // The cells jumped over are kept for the backtracking, not queued
+                if (isLanding || frontier.contains(nextWindowId)) {
+                    float estCost = getEstimatedCostOfNext<Mode>(prevCameFrom, prev, next, this->current_targeted_pin) + targetDistanceCost(next);
+                    frontier.push(nextWindowId, pr::addCost(pr::addCost(new_cost, pr::toCost(estCost * this->mHeuristicWeight)), bendCost));
                 }
             }
+            prev = next;
+            prevWindowId = nextWindowId;
+        }
+    }
+}
+
+template <typename Mode>
+bool BoardGrid::jump(const Location &l, const int dx, const int dy, Location &landing, int &steps) const {
+    Location cell = l;
+    steps = 0;
+    while (true) {
+        cell.m_x += dx;
+        cell.m_y += dy;
+        ++steps;
+        if (!this->validate_location(cell) || !this->mSearchWindow.contains(cell) || !this->inSearchCorridor(cell)) {
+            // Lands on the last cell inside, which is expanded one step at a time from the edge
+            cell.m_x -= dx;
+            cell.m_y -= dy;
+            --steps;
+            if (steps == 0) return false;
+            break;
+        }
+        // Two tiles at most, a longer run mostly writes cells past the ones A* expands
+        if (this->isTargetedPin(cell) || !this->isOpenCell(cell) || steps >= 2 << this->mJumpTileShift) {
+            break;
+        }
+        // Turning points, towards a targeted pin or a change of cost
+        if (dx != 0 && dy != 0) {
+            if (this->scanForLanding(cell, dx, 0) || this->scanForLanding(cell, 0, dy)) break;
+        } else if (!Mode::kDiagonal) {
+            if (this->scanForLanding(cell, dy, dx) || this->scanForLanding(cell, -dy, -dx)) break;
         }
     }
+    landing = cell;
+    return true;
 }
 
-void BoardGrid::initializeFrontiers(const MultipinRoute &route, LocationQueue<Location, float> &frontier) {
+bool BoardGrid::scanForLanding(const Location &l, const int dx, const int dy) const {
+    // A targeted pin ahead, even past the window, only costs a landing more
+    for (const auto &pin : this->currentTargetedPinWithLayers) {
+        if (pin.m_z == l.m_z && (dx != 0 ? pin.m_y == l.m_y && (pin.m_x - l.m_x) * dx > 0 : pin.m_x == l.m_x && (pin.m_y - l.m_y) * dy > 0)) {
+            return true;
+        }
+    }
+    // l is open, so is the rest of its tile: walk tile by tile
+    Location cell = l;
+    while (true) {
+        if (dx != 0) {
+            cell.m_x = dx > 0 ? ((cell.m_x >> this->mJumpTileShift) + 1) << this->mJumpTileShift : ((cell.m_x >> this->mJumpTileShift) << this->mJumpTileShift) - 1;
+        } else {
+            cell.m_y = dy > 0 ? ((cell.m_y >> this->mJumpTileShift) + 1) << this->mJumpTileShift : ((cell.m_y >> this->mJumpTileShift) << this->mJumpTileShift) - 1;
+        }
+        if (!this->validate_location(cell) || !this->mSearchWindow.contains(cell) || !this->inSearchCorridor(cell)) {
+            return false;
+        }
+        if (!this->isOpenCell(cell)) {
+            return true;
+        }
+    }
+}
+
+bool BoardGrid::aStarSearchingBidirectional(MultipinRoute &route, Location &meet, float &finalCost) {
+    return dispatchSearchMode(GlobalParam::gUseMircoVia, !GlobalParam::g90DegreeMode, GlobalParam::gBendingAwareSearch, [&](auto mode) {
+        return this->aStarSearchingBidirectionalWithMode<decltype(mode)>(route, meet, finalCost);
+    });
+}
+
+template <typename Mode>
+bool BoardGrid::aStarSearchingBidirectionalWithMode(MultipinRoute &route, Location &meet, float &finalCost) {
+    int margin = GlobalParam::gSearchWindowMargin;
+    bool found = false;
+    const bool useSearchCorridor = this->mUseSearchCorridor;
+    while (true) {
+        this->setupSearchWindow(route, margin);
+        this->mBackwardSearchWindow.setup(this->mSearchWindow.minX(), this->mSearchWindow.maxX(), this->mSearchWindow.minY(), this->mSearchWindow.maxY(), this->l);
+        found = this->aStarSearchingBidirectionalInWindow<Mode>(route, meet, finalCost);
+        if (found || this->expansionLimitReached()) break;
+        if (this->searchWindowCoversBoard()) {
+            if (!this->mUseSearchCorridor) break;
+            // No path inside the corridor of the global route, search the whole board
+            std::cout << __FUNCTION__ << "(): no path in the search corridor, retry without it" << std::endl;
+            this->mUseSearchCorridor = false;
+            continue;
+        }
+
+        // No path inside the window, grow it and search again
+        margin = std::max(2 * margin, 1);
+        std::cout << __FUNCTION__ << "(): no path in the search window, retry with margin " << margin << std::endl;
+    }
+    // The next connections of the net keep the corridor
+    this->mUseSearchCorridor = useSearchCorridor;
+    return found;
+}
+
+template <typename Mode>
+bool BoardGrid::aStarSearchingBidirectionalInWindow(MultipinRoute &route, Location &meet, float &finalCost) {
+    std::cout << __FUNCTION__ << "() nets: window: (" << this->mSearchWindow.minX() << ", " << this->mSearchWindow.minY() << ") - ("
+              << this->mSearchWindow.maxX() << ", " << this->mSearchWindow.maxY() << ")" << std::endl;
+
+    // Both windows have the same bounds, so a cell has the same id in both
+    SearchWindow &forwardWindow = this->mSearchWindow;
+    SearchWindow &backwardWindow = this->mBackwardSearchWindow;
+    FrontierHeap &forwardFrontier = this->mFrontier;
+    FrontierHeap &backwardFrontier = this->mBackwardFrontier;
+    forwardFrontier.reset(forwardWindow.numCells());
+    backwardFrontier.reset(backwardWindow.numCells());
+
+    // Keys use the average of the two estimates, (to target - to source) / 2 forward and its negation
+    // backward. Unlike the estimate with the bending bonuses it is consistent, which allows stopping
+    // as soon as the two front keys add up to the best path found.
+    const Location source = route.mGridPins.front().pinWithLayers.front();
+    const Location target = this->current_targeted_pin;
+    auto potential = [&](const Location &l, const Location &towards, const Location &awayFrom) {
+        return 0.5f * (this->getEstimatedCost<Mode>(l, towards) - this->getEstimatedCost<Mode>(l, awayFrom));
+    };
+    auto initialize = [&](const std::vector<Location> &pins, SearchWindow &window, FrontierHeap &frontier, const Location &towards, const Location &awayFrom) {
+        for (const auto &pt : pins) {
+            const int id = window.id(pt);
+            window.setWorkingCost(id, 0);
+            window.setCameFrom(id, CAME_FROM_SOURCE);
+            frontier.push(id, pr::toCost(potential(pt, towards, awayFrom)));
+        }
+    };
+    initialize(route.mGridPins.front().pinWithLayers, forwardWindow, forwardFrontier, target, source);
+    initialize(this->currentTargetedPinWithLayers, backwardWindow, backwardFrontier, source, target);
+
+    // Best path through a cell reached from both sides, with the bend where the two halves join
+    pr::prCost bestCost = pr::kCostInfinity;
+    int bestMeetId = -1;
+    auto meetAt = [&](const int id) {
+        const std::uint8_t forwardCameFrom = forwardWindow.cameFrom(id);
+        const std::uint8_t backwardCameFrom = backwardWindow.cameFrom(id);
+        pr::prCost joinBendCost = 0;
+        if (Mode::kBendingAware && forwardCameFrom != CAME_FROM_SOURCE && backwardCameFrom != CAME_FROM_SOURCE) {
+            Location l, next;
+            forwardWindow.idToLocation(id, l);
+            SearchWindow::cameFromLocation(l, backwardCameFrom, next);
+            joinBendCost = SearchWindow::isStraight(forwardCameFrom, l, next) ? 0 : pr::toCost(1);
+        }
+        pr::prCost cost = pr::addCost(forwardWindow.workingCost(id), forwardWindow.bendingCost(id));
+        cost = pr::addCost(cost, backwardWindow.workingCost(id));
+        cost = pr::addCost(cost, backwardWindow.bendingCost(id));
+        cost = pr::addCost(cost, joinBendCost);
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestMeetId = id;
+        }
+    };
+    for (const auto &pt : this->currentTargetedPinWithLayers) {
+        // Pins sharing cells
+        if (forwardWindow.cameFrom(forwardWindow.id(pt)) != CAME_FROM_NONE) {
+            meetAt(forwardWindow.id(pt));
+        }
+    }
+
+    const auto &traceRelativeSearchGrids = mGridNetclasses.at(currentGridNetclassId).getTraceSearchingSpaceToGrids();
+    int numForwardExpanded = 0;
+    int numBackwardExpanded = 0;
+
+    // Expands the front of one direction. The backward search walks the edges of the forward one
+    // in reverse, so a step into next costs what the forward step from next into current would.
+    auto expand = [&](SearchWindow &window, FrontierHeap &frontier, const SearchWindow &otherWindow, const Location &towards, const Location &awayFrom, auto backward) {
+        const int currentWindowId = frontier.frontId();
+        Location current;
+        window.idToLocation(currentWindowId, current);
+        frontier.pop();
+        ++this->mConnectionStats.numPops;
+
+        const pr::prCost current_cost = window.workingCost(currentWindowId);
+        const pr::prCost currentBendingCost = window.bendingCost(currentWindowId);
+        const std::uint8_t currentCameFrom = window.cameFrom(currentWindowId);
+        pr::prCost currentTraceCost = 0;
+        pr::prCost currentLayerPrefCost = 0;
+        if (decltype(backward)::value) {
+            currentTraceCost = this->traceStepCost(current, this->locationToId(current), 0.0, traceRelativeSearchGrids);
+            currentLayerPrefCost = pr::toCost(getLayerPrefCost(route, current));
+        }
+
+        this->forEachNeighbor<Mode>(current, currentCameFrom, [&](const Location &next, const int nextId, const pr::prCost stepCost) {
+            ++this->mConnectionStats.numNeighbors;
+            if (!window.contains(next) || !this->inSearchCorridor(next)) {
+                return;
+            }
+            const int nextWindowId = window.id(next);
+            pr::prCost new_cost = current_cost;
+            if (!decltype(backward)::value) {
+                new_cost = pr::addCost(new_cost, stepCost);
+                new_cost = pr::addCost(new_cost, pr::toCost(getLayerPrefCost(route, next)));
+            } else if (next.m_z != current.m_z) {
+                // Via costs only depend on the xy
+                new_cost = pr::addCost(new_cost, stepCost);
+                new_cost = pr::addCost(new_cost, currentLayerPrefCost);
+            } else {
+                pr::prCost reverseStepCost = pr::toCost((next.m_x != current.m_x && next.m_y != current.m_y) ? GlobalParam::gDiagonalCost : 1.0);
+                reverseStepCost = pr::addCost(reverseStepCost, currentTraceCost);
+                new_cost = pr::addCost(new_cost, reverseStepCost);
+                new_cost = pr::addCost(new_cost, currentLayerPrefCost);
+            }
+
+            pr::prCost bendCost = 0;
+            if (Mode::kBendingAware) {
+                // Straightness does not depend on the direction of travel, so both halves count the same bends
+                bendCost = currentBendingCost;
+                if (currentCameFrom != CAME_FROM_SOURCE && !SearchWindow::isStraight(currentCameFrom, current, next)) {
+                    bendCost = pr::addCost(bendCost, pr::toCost(1));
+                }
+            }
+
+            if (pr::addCost(new_cost, bendCost) < pr::addCost(window.workingCost(nextWindowId), window.bendingCost(nextWindowId))) {
+                window.setWorkingCost(nextWindowId, new_cost);
+                window.setBendingCost(nextWindowId, bendCost);
+                window.setCameFrom(nextWindowId, SearchWindow::cameFromCode(next, current));
+
+                frontier.push(nextWindowId, pr::addCost(pr::addCost(new_cost, bendCost), pr::toCost(potential(next, towards, awayFrom))));
+
+                if (otherWindow.cameFrom(nextWindowId) != CAME_FROM_NONE) {
+                    meetAt(nextWindowId);
+                }
+            }
+        });
+    };
+
+    while (!forwardFrontier.empty() && !backwardFrontier.empty()) {
+        // The potentials cancel out, a path cheaper than the best one found would need front keys adding up to less
+        if (bestCost <= pr::addCost(forwardFrontier.frontKey(), backwardFrontier.frontKey())) {
+            break;
+        }
+        // The best path met so far, if any
+        if (this->expansionLimitReached()) {
+            std::cout << __FUNCTION__ << "(): expansion limit reached" << std::endl;
+            break;
+        }
+        // Expand the smaller frontier
+        if (forwardFrontier.size() <= backwardFrontier.size()) {
+            expand(forwardWindow, forwardFrontier, backwardWindow, target, source, std::false_type());
+            ++numForwardExpanded;
+        } else {
+            expand(backwardWindow, backwardFrontier, forwardWindow, source, target, std::true_type());
+            ++numBackwardExpanded;
+        }
+    }
+
+    if (bestMeetId < 0) {
+        return false;
+    }
+    forwardWindow.idToLocation(bestMeetId, meet);
+    finalCost = pr::fromCost(bestCost);
+    std::cout << "=> Meet at: " << meet << " with cost at " << finalCost << ", expanded " << numForwardExpanded << " + " << numBackwardExpanded << " cells" << std::endl;
+    return true;
+}
+
+template <typename Frontier>
+void BoardGrid::initializeFrontiers(const MultipinRoute &route, Frontier &frontier) {
     if (route.getGridPaths().empty()) {
         // First pair of routing
         for (const auto &pt : route.mGridPins.front().pinWithLayers) {
@@ -558,48 +1363,54 @@ void BoardGrid::initializeFrontiers(const MultipinRoute &route, LocationQueue<Lo
     }
 
     for (const auto &gp : route.getGridPaths()) {
-        const auto &locations = gp.getLocations();
-        if (locations.size() == 1) {
-            initializeLocationToFrontier(locations.front(), frontier);
-            continue;
-        }
+        this->initializeGridPathToFrontier(gp, frontier);
+    }
+}
 
-        auto pointIte = ++locations.begin();
-        auto prevPointIte = locations.begin();
+template <typename Frontier>
+void BoardGrid::initializeGridPathToFrontier(const GridPath &gp, Frontier &frontier) {
+    const auto &locations = gp.getLocations();
+    if (locations.size() == 1) {
+        initializeLocationToFrontier(locations.front(), frontier);
+        return;
+    }
 
-        for (; pointIte != locations.end();) {
-            // TODO: Through hole pins? how to put layers of through hole pins into frontier
-            if (pointIte->m_x == prevPointIte->m_x && pointIte->m_y == prevPointIte->m_y && pointIte->m_z != prevPointIte->m_z) {
-                // A via
-                if (GlobalParam::gUseMircoVia) {
-                    // Micro vias / Blind/buried vias
-                    for (int z = std::min(pointIte->m_z, prevPointIte->m_z); z <= std::max(pointIte->m_z, prevPointIte->m_z); ++z) {
-                        Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
-                        initializeLocationToFrontier(viaLocationOnALayer, frontier);
-                    }
-                } else {
-                    // Put all the layers (through hole via) into the frontiers
-                    for (int z = 0; z < this->l; ++z) {
-                        Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
-                        initializeLocationToFrontier(viaLocationOnALayer, frontier);
-                    }
+    auto pointIte = ++locations.begin();
+    auto prevPointIte = locations.begin();
+
+    for (; pointIte != locations.end();) {
+        // TODO: Through hole pins? how to put layers of through hole pins into frontier
+        if (pointIte->m_x == prevPointIte->m_x && pointIte->m_y == prevPointIte->m_y && pointIte->m_z != prevPointIte->m_z) {
+            // A via
+            if (GlobalParam::gUseMircoVia) {
+                // Micro vias / Blind/buried vias
+                for (int z = std::min(pointIte->m_z, prevPointIte->m_z); z <= std::max(pointIte->m_z, prevPointIte->m_z); ++z) {
+                    Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
+                    initializeLocationToFrontier(viaLocationOnALayer, frontier);
                 }
             } else {
-                // Normal points
-                initializeLocationToFrontier(*pointIte, frontier);
-
-                if (prevPointIte == locations.begin()) {
-                    initializeLocationToFrontier(*prevPointIte, frontier);
+                // Put all the layers (through hole via) into the frontiers
+                for (int z = 0; z < this->l; ++z) {
+                    Location viaLocationOnALayer{pointIte->m_x, pointIte->m_y, z};
+                    initializeLocationToFrontier(viaLocationOnALayer, frontier);
                 }
             }
+        } else {
+            // Normal points
+            initializeLocationToFrontier(*pointIte, frontier);
 
-            ++pointIte;
-            ++prevPointIte;
+            if (prevPointIte == locations.begin()) {
+                initializeLocationToFrontier(*prevPointIte, frontier);
+            }
         }
+
+        ++pointIte;
+        ++prevPointIte;
     }
 }
 
-void BoardGrid::initializeFrontiers(const std::vector<Location> &route, LocationQueue<Location, float> &frontier) {
+template <typename Frontier>
+void BoardGrid::initializeFrontiers(const std::vector<Location> &route, Frontier &frontier) {
     if (route.empty()) {
         return;
     }
@@ -638,43 +1449,49 @@ void BoardGrid::initializeFrontiers(const std::vector<Location> &route, Location
     }
 }
 
-void BoardGrid::initializeLocationToFrontier(const Location &start, LocationQueue<Location, float> &frontier) {
+template <typename Frontier>
+void BoardGrid::initializeLocationToFrontier(const Location &start, Frontier &frontier) {
     // Walked cost (= 0) + estimated future cost
     // 2D cost estimation
-    float cost = getEstimatedCost(start);
+    float cost = (getEstimatedCost(start) + targetDistanceCost(start)) * this->mHeuristicWeight;
     // 3D cost estimation
     //float cost = getEstimatedCostWithLayers(start);
 
     this->working_cost_set(0.0, start);
-    frontier.push(start, cost);
+    this->bending_cost_set(0.0, start);
+    frontier.push(this->mSearchWindow.id(start), pr::toCost(cost));
     // std::cerr << "\tPQ: cost: " << cost << ", at" << start << std::endl;
 
     // Set a ending for the backtracking
-    this->setCameFromId(start, this->locationToId(start));
+    this->setCameFrom(start, start);
 }
 
 float BoardGrid::getEstimatedCost(const Location &l) {
     // return max(abs(l.m_x - this->current_targeted_pin.m_x), abs(l.m_y - this->current_targeted_pin.m_y));
+    // Once per source, the kernels call the SearchMode one
+    if (GlobalParam::g90DegreeMode) {
+        return this->getEstimatedCost<SearchMode<true, false, false>>(l, this->current_targeted_pin);
+    }
+    return this->getEstimatedCost<SearchMode<true, true, false>>(l, this->current_targeted_pin);
+}
 
-    int absDiffX = abs(l.m_x - this->current_targeted_pin.m_x);
-    int absDiffY = abs(l.m_y - this->current_targeted_pin.m_y);
+template <typename Mode>
+float BoardGrid::getEstimatedCost(const Location &l, const Location &target) const {
+    int absDiffX = abs(l.m_x - target.m_x);
+    int absDiffY = abs(l.m_y - target.m_y);
+    if (!Mode::kDiagonal) {
+        return (float)(absDiffX + absDiffY);
+    }
     int minDiff = min(absDiffX, absDiffY);
     int maxDiff = max(absDiffX, absDiffY);
     return (float)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff;
 }
 
 float BoardGrid::getEstimatedCostWithBendingCost(const Location &current, const Location &next) {
-    int currentId = this->locationToId(current);
-    int prevId = this->getCameFromId(current);
+    std::uint8_t cameFrom = this->getCameFrom(current);
     float bendingCost = 0;
-    if (prevId != currentId) {
-        Location prev;
-        this->idToLocation(prevId, prev);
-
-        if (prev.z() == current.z() &&
-            current.z() == next.z() &&
-            prev.x() - current.x() == current.x() - next.x() &&
-            prev.y() - current.y() == current.y() - next.y()) {
+    if (cameFrom != CAME_FROM_SOURCE) {
+        if (SearchWindow::isStraight(cameFrom, current, next)) {
             bendingCost += 0.5;
         }
     } else {
@@ -696,21 +1513,35 @@ float BoardGrid::getEstimatedCostWithBendingCost(const Location &current, const
     return (float)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff - bendingCost;
 }
 
+template <typename Mode>
+float BoardGrid::getEstimatedCostOfNext(const std::uint8_t currentCameFrom, const Location &current, const Location &next, const Location &target) const {
+    int absDiffX = abs(next.m_x - target.m_x);
+    int absDiffY = abs(next.m_y - target.m_y);
+    // Bonuses as in getEstimatedCostWithBendingCost(), the starting point counts as zero bending
+    float bendingCost = 0;
+    if (Mode::kBendingAware) {
+        if (currentCameFrom == CAME_FROM_SOURCE || SearchWindow::isStraight(currentCameFrom, current, next)) {
+            bendingCost += 0.5;
+        }
+        if (absDiffX == 0 || absDiffY == 0 || (Mode::kDiagonal && absDiffX == absDiffY)) {
+            bendingCost += 0.5;
+        }
+    }
+    if (!Mode::kDiagonal) {
+        return (float)(absDiffX + absDiffY) - bendingCost;
+    }
+    int minDiff = min(absDiffX, absDiffY);
+    int maxDiff = max(absDiffX, absDiffY);
+    return (float)minDiff * GlobalParam::gDiagonalCost + maxDiff - minDiff - bendingCost;
+}
+
 int BoardGrid::getBendingCostOfNext(const Location &current, const Location &next) const {
     int currentBendingCost = this->bending_cost_at(current);
-    int currentId = this->locationToId(current);
-    int prevId = this->getCameFromId(current);
+    std::uint8_t cameFrom = this->getCameFrom(current);
     int nextBendingCost = currentBendingCost;
 
-    if (prevId != currentId) {
-        Location prev;
-        this->idToLocation(prevId, prev);
-
-        if (prev.z() == current.z() &&
-            current.z() == next.z() &&
-            prev.x() - current.x() == current.x() - next.x() &&
-            prev.y() - current.y() == current.y() - next.y()) {
-        } else {
+    if (cameFrom != CAME_FROM_SOURCE) {
+        if (!SearchWindow::isStraight(cameFrom, current, next)) {
             nextBendingCost += 1;
         }
     } else {
@@ -747,19 +1578,10 @@ float BoardGrid::getEstimatedCostWithLayers(const Location &l) {
 
 float BoardGrid::getEstimatedCostWithLayersAndBendingCost(const Location &current, const Location &next) {
     // Bending cost
-    int currentId = this->locationToId(current);
-    int prevId = this->getCameFromId(current);
+    std::uint8_t cameFrom = this->getCameFrom(current);
     float bendingCost = 0;
-    if (prevId != currentId) {
-        Location prev;
-        this->idToLocation(prevId, prev);
-
-        if (prev.z() == current.z() &&
-            current.z() == next.z() &&
-            prev.x() - current.x() == current.x() - next.x() &&
-            prev.y() - current.y() == current.y() - next.y()) {
-            bendingCost = 0.5;
-        }
+    if (cameFrom != CAME_FROM_SOURCE && SearchWindow::isStraight(cameFrom, current, next)) {
+        bendingCost = 0.5;
     }
 
     int absDiffX = abs(next.m_x - this->currentTargetedPinWithLayers.front().m_x);
@@ -775,138 +1597,117 @@ float BoardGrid::getEstimatedCostWithLayersAndBendingCost(const Location &curren
     return estCost;
 }
 
-void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Location>> &ns) {
+pr::prCost BoardGrid::traceStepCost(const Location &next, const int nextId, const double stepCost, const std::vector<Point_2D<int>> &traceRelativeSearchGrids) {
+    float cost = stepCost;
+    if (this->mNetStampPlane.get(nextId) != this->mNetEpoch || this->decodeCachedCost(this->mCachedTraceCostPlane.get(nextId)) < -0.5) {
+        // Vector based searching
+        cost += sized_trace_cost_at(next, traceRelativeSearchGrids);
+
+        // Incremental searching
+        // cost += currentGridPenalty;
+        // cost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLeftAddGrids());
+        // cost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLeftDedGrids());
+
+        // Put in the cache
+        this->touchNetScratch(nextId);
+        this->mCachedTraceCostPlane[nextId] = this->encodeCachedCost(cost - stepCost);
+    } else {
+        cost += this->decodeCachedCost(this->mCachedTraceCostPlane.get(nextId));
+    }
+    return pr::toCost(cost);
+}
+
+template <typename Mode, typename Visitor>
+void BoardGrid::forEachNeighbor(const Location &l, const std::uint8_t cameFrom, Visitor &&visit) {
     auto &curGridNetclass = mGridNetclasses.at(currentGridNetclassId);
     const auto &traceRelativeSearchGrids = curGridNetclass.getTraceSearchingSpaceToGrids();
-    const auto &viaRelativeSearchGrids = curGridNetclass.getViaSearchingSpaceToGrids();
-
-    // For incremental cost update of trace
-    // auto currentGridPenalty = this->cached_trace_cost_at(l);
 
     // left
     if (l.m_x - 1 > -1) {
-        Location left{l.m_x - 1, l.m_y, l.m_z};
-        float leftCost = 1.0;
-
-        if (this->cached_trace_cost_at(left) == -1) {
-            // Radius based searching
-            //leftCost += sized_trace_cost_at(left, traceSearchRadius);
-            // Vector based searching
-            leftCost += sized_trace_cost_at(left, traceRelativeSearchGrids);
-
-            // Incremental searching
-            // leftCost += currentGridPenalty;
-            // leftCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLeftAddGrids());
-            // leftCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLeftDedGrids());
-
-            // Put in the cache
-            this->cached_trace_cost_set(leftCost - 1.0, left);
-        } else {
-            leftCost += this->cached_trace_cost_at(left);
-        }
-        // float golden = sized_trace_cost_at(left, traceRelativeSearchGrids);
-        // if(golden != cached_trace_cost_at(left) ){
-        //     std::cout << "Cost at "<<left<<": golden: " << golden << ", incremental: " << cached_trace_cost_at(left) << std::endl;
-        // }
-
-        // See if is negative cost
-        // if (leftCost < 0.0) {
-        //     float golden = sized_trace_cost_at(left, traceRelativeSearchGrids);
-        //     std::cout << "Cost at " << left << ": golden: " << golden << ", incremental: " << cached_trace_cost_at(left) << std::endl;
-        // }
-        ns.push_back(std::pair<float, Location>(leftCost, left));
+        const Location left{l.m_x - 1, l.m_y, l.m_z};
+        const int leftId = this->locationToId(left);
+        visit(left, leftId, this->traceStepCost(left, leftId, 1.0, traceRelativeSearchGrids));
     }
 
     // right
     if (l.m_x + 1 < this->w) {
-        Location right{l.m_x + 1, l.m_y, l.m_z};
-        float rightCost = 1.0;
-
-        if (this->cached_trace_cost_at(right) == -1) {
-            //rightCost += sized_trace_cost_at(right, traceSearchRadius);
-            rightCost += sized_trace_cost_at(right, traceRelativeSearchGrids);
-
-            // Incremental searching
-            // rightCost += currentGridPenalty;
-            // rightCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRightAddGrids());
-            // rightCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRightDedGrids());
-
-            // Put in cache
-            this->cached_trace_cost_set(rightCost - 1.0, right);
-        } else {
-            rightCost += this->cached_trace_cost_at(right);
-        }
-        ns.push_back(std::pair<float, Location>(rightCost, right));
+        const Location right{l.m_x + 1, l.m_y, l.m_z};
+        const int rightId = this->locationToId(right);
+        visit(right, rightId, this->traceStepCost(right, rightId, 1.0, traceRelativeSearchGrids));
     }
 
     // forward
     if (l.m_y + 1 < this->h) {
-        Location forward{l.m_x, l.m_y + 1, l.m_z};
-        float forwardCost = 1.0;
+        const Location forward{l.m_x, l.m_y + 1, l.m_z};
+        const int forwardId = this->locationToId(forward);
+        visit(forward, forwardId, this->traceStepCost(forward, forwardId, 1.0, traceRelativeSearchGrids));
+    }
 
-        if (this->cached_trace_cost_at(forward) == -1) {
-            //forwardCost += sized_trace_cost_at(forward, traceSearchRadius);
-            forwardCost += sized_trace_cost_at(forward, traceRelativeSearchGrids);
+    // back
+    if (l.m_y - 1 > -1) {
+        const Location backward{l.m_x, l.m_y - 1, l.m_z};
+        const int backwardId = this->locationToId(backward);
+        visit(backward, backwardId, this->traceStepCost(backward, backwardId, 1.0, traceRelativeSearchGrids));
+    }
 
-            // Incremental searching
-            // forwardCost += currentGridPenalty;
-            // forwardCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getForwardAddGrids());
-            // forwardCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getForwardDedGrids());
+    this->forEachLayerNeighbor<Mode>(l, cameFrom, visit);
 
-            // Put in cache
-            this->cached_trace_cost_set(forwardCost - 1.0, forward);
-        } else {
-            forwardCost += this->cached_trace_cost_at(forward);
-        }
-        ns.push_back(std::pair<float, Location>(forwardCost, forward));
+    if (!Mode::kDiagonal) {
+        return;
     }
 
-    // back
-    if (l.m_y - 1 > -1) {
-        Location backward{l.m_x, l.m_y - 1, l.m_z};
-        float backwardCost = 1.0;
+    // lf
+    if (l.m_x - 1 > -1 && l.m_y + 1 < this->h) {
+        const Location lf{l.m_x - 1, l.m_y + 1, l.m_z};
+        const int lfId = this->locationToId(lf);
+        visit(lf, lfId, this->traceStepCost(lf, lfId, GlobalParam::gDiagonalCost, traceRelativeSearchGrids));
+    }
 
-        if (this->cached_trace_cost_at(backward) == -1) {
-            //backwardCost += sized_trace_cost_at(backward, traceSearchRadius);
-            backwardCost += sized_trace_cost_at(backward, traceRelativeSearchGrids);
+    // lb
+    if (l.m_x - 1 > -1 && l.m_y - 1 > -1) {
+        const Location lb{l.m_x - 1, l.m_y - 1, l.m_z};
+        const int lbId = this->locationToId(lb);
+        visit(lb, lbId, this->traceStepCost(lb, lbId, GlobalParam::gDiagonalCost, traceRelativeSearchGrids));
+    }
 
-            // Incremental searching
-            // backwardCost += currentGridPenalty;
-            // backwardCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getBackwardAddGrids());
-            // backwardCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getBackwardDedGrids());
+    // rf
+    if (l.m_x + 1 < this->w && l.m_y + 1 < this->h) {
+        const Location rf{l.m_x + 1, l.m_y + 1, l.m_z};
+        const int rfId = this->locationToId(rf);
+        visit(rf, rfId, this->traceStepCost(rf, rfId, GlobalParam::gDiagonalCost, traceRelativeSearchGrids));
+    }
 
-            // Put in cache
-            this->cached_trace_cost_set(backwardCost - 1.0, backward);
-        } else {
-            backwardCost += this->cached_trace_cost_at(backward);
-        }
-        ns.push_back(std::pair<float, Location>(backwardCost, backward));
+    // rb
+    if (l.m_x + 1 < this->w && l.m_y - 1 > -1) {
+        const Location rb{l.m_x + 1, l.m_y - 1, l.m_z};
+        const int rbId = this->locationToId(rb);
+        visit(rb, rbId, this->traceStepCost(rb, rbId, GlobalParam::gDiagonalCost, traceRelativeSearchGrids));
     }
+}
+
+template <typename Mode, typename Visitor>
+void BoardGrid::forEachLayerNeighbor(const Location &l, const std::uint8_t cameFrom, Visitor &&visit) {
+    auto &curGridNetclass = mGridNetclasses.at(currentGridNetclassId);
+    const auto &viaRelativeSearchGrids = curGridNetclass.getViaSearchingSpaceToGrids();
 
-    if (GlobalParam::gUseMircoVia) {
+    if (Mode::kMicroVia) {
         // up
         if (l.m_z + 1 < this->l) {
-            Location up{l.m_x, l.m_y, l.m_z + 1};
+            const Location up{l.m_x, l.m_y, l.m_z + 1};
             float upCost = 0.0;
 
             sizedViaCostBetweenStartEndLayer(l, l.m_z, l.m_z + 1, viaRelativeSearchGrids, upCost);
             upCost += GlobalParam::gLayerChangeCost;
-            ns.push_back(std::pair<float, Location>(upCost, up));
-
-            // Incremental searching
-            // this->cached_trace_cost_set(sized_trace_cost_at(up, traceRelativeSearchGrids), up);
+            visit(up, this->locationToId(up), pr::toCost(upCost));
         }
         // down
         if (l.m_z - 1 > -1) {
-            Location down{l.m_x, l.m_y, l.m_z - 1};
+            const Location down{l.m_x, l.m_y, l.m_z - 1};
             float downCost = 0.0;
 
             sizedViaCostBetweenStartEndLayer(l, l.m_z - 1, l.m_z, viaRelativeSearchGrids, downCost);
             downCost += GlobalParam::gLayerChangeCost;
-            ns.push_back(std::pair<float, Location>(downCost, down));
-
-            // Incremental searching
-            // this->cached_trace_cost_set(sized_trace_cost_at(down, traceRelativeSearchGrids), down);
+            visit(down, this->locationToId(down), pr::toCost(downCost));
         }
     } else {
         // Make a through hole via
@@ -914,240 +1715,51 @@ void BoardGrid::getNeighbors(const Location &l, std::vector<std::pair<float, Loc
         Location viaCachedLocation{l.m_x, l.m_y, 0};
         // Correct Implementation
         // if (sizedViaExpandableAndCost(l, viaRelativeSearchGrids, viaCost)) {
-        //     //std::cout << "VIA cached missed at " << viaCachedLocation << ", cost: " << viaCost << std::endl;
         //     viaCost += GlobalParam::gLayerChangeCost;
-
-        //     // Put all the layers (through hole via) into the neighbors
-        //     for (int z = 0; z < this->l; ++z) {
-        //         Location viaLayer{l.m_x, l.m_y, z};
-        //         ns.push_back(std::pair<float, Location>(viaCost, viaLayer));
-        //     }
+        //     ...all the layers...
         // }
 
         // Trying to cached the via cost
         if (this->cached_via_cost_at(viaCachedLocation) < -1.5) {
             // ViaForbidden location, do nothing
         } else {
+            bool viaExpandable = true;
             if (this->cached_via_cost_at(viaCachedLocation) < -0.5) {
                 ++this->viaCachedMissed;
 
                 // For incremental Via cost update
-                int currentId = this->locationToId(l);
-                int prevId = this->getCameFromId(currentId);
                 Location prevLocation;
-                this->idToLocation(prevId, prevLocation);
+                SearchWindow::cameFromLocation(l, cameFrom, prevLocation);
                 prevLocation.m_z = 0;  // To access the cache
                 auto prevLocViaCost = this->cached_via_cost_at(prevLocation);
 
-                // No cached via cost value - correct implementation
-                // if (sizedViaExpandableAndCost(l, viaRelativeSearchGrids, viaCost)) {
                 // No cached via cost value => try incremental cost updating
-                if (sizedViaExpandableAndIncrementalCost(l, viaRelativeSearchGrids, prevLocation, prevLocViaCost, curGridNetclass.getViaIncrementalSearchGrids(), viaCost)) {
-                    // Put in the cache
-                    this->cached_via_cost_set(viaCost, viaCachedLocation);
-
-                    viaCost += GlobalParam::gLayerChangeCost;
-
-                    // Put all the layers (through hole via) into the neighbors
-                    for (int z = 0; z < this->l; ++z) {
-                        Location viaLayer{l.m_x, l.m_y, z};
-                        ns.push_back(std::pair<float, Location>(viaCost, viaLayer));
-                    }
-                } else {
-                    // Put in the cache the via forbidden flag
-                    this->cached_via_cost_set(-2.0, viaCachedLocation);
-                }
-
+                viaExpandable = sizedViaExpandableAndIncrementalCost(l, viaRelativeSearchGrids, prevLocation, prevLocViaCost, curGridNetclass.getViaIncrementalSearchGrids(), viaCost);
+                // Put in the cache, or the via forbidden flag
+                this->cached_via_cost_set(viaExpandable ? viaCost : -2.0, viaCachedLocation);
+                viaCost += GlobalParam::gLayerChangeCost;
             } else {
                 ++this->viaCachedHit;
 
                 // Got a cached via cost value
                 viaCost = this->cached_via_cost_at(viaCachedLocation) + GlobalParam::gLayerChangeCost;
+            }
 
+            if (viaExpandable) {
                 // Put all the layers (through hole via) into the neighbors
                 for (int z = 0; z < this->l; ++z) {
-                    Location viaLayer{l.m_x, l.m_y, z};
-                    ns.push_back(std::pair<float, Location>(viaCost, viaLayer));
+                    const Location viaLayer{l.m_x, l.m_y, z};
+                    visit(viaLayer, this->locationToId(viaLayer), pr::toCost(viaCost));
                 }
             }
         }
     }
-
-    /*
-    // up
-    if (l.m_z + 1 < this->l) {
-        Location up{l.m_x, l.m_y, l.m_z + 1};
-        float upCost = 0.0;
-
-        // if (this->cached_via_cost_at(up) == -2) {
-        //     // ViaForbidden location, do nothing
-        // } else if (this->cached_via_cost_at(up) == -1) {
-        //     // No cached via cost value
-        //     if (sizedViaExpandableAndCost(up, viaRelativeSearchGrids, upCost)) {
-        //         // Put in the cache
-        //         this->cached_via_cost_set(upCost, up);
-
-        //         upCost += GlobalParam::gLayerChangeCost;
-        //         ns.push_back(std::pair<float, Location>(upCost, up));
-
-        //         // For Incremental searching, which assume the previous grid done the cost calculation
-        //         // this->cached_trace_cost_set(sized_trace_cost_at(up, traceRelativeSearchGrids), up);
-        //     } else {
-        //         // Put in the cache the forbidden flag
-        //         this->cached_via_cost_set(-2, up);
-        //     }
-        // } else {
-        //     // Got a cached via cost value
-        //     upCost += this->cached_via_cost_at(up);
-        //     upCost += GlobalParam::gLayerChangeCost;
-        // }
-
-        //===Original Implementation===
-        if (sizedViaExpandableAndCost(l, viaRelativeSearchGrids, upCost)) {
-            upCost += GlobalParam::gLayerChangeCost;
-            ns.push_back(std::pair<float, Location>(upCost, up));
-
-            // Incremental searching
-            // this->cached_trace_cost_set(sized_trace_cost_at(up, traceRelativeSearchGrids), up);
-        }
-    }
-
-    // down
-    if (l.m_z - 1 > -1) {
-        Location down{l.m_x, l.m_y, l.m_z - 1};
-        float downCost = 0.0;
-
-        // if (this->cached_via_cost_at(down) == -2) {
-        //     // ViaForbidden location, do nothing
-        // } else if (this->cached_via_cost_at(down) == -1) {
-        //     // No cached via cost value
-        //     if (sizedViaExpandableAndCost(down, viaRelativeSearchGrids, downCost)) {
-        //         // Put in the cache
-        //         this->cached_via_cost_set(downCost, down);
-
-        //         downCost += GlobalParam::gLayerChangeCost;
-        //         ns.push_back(std::pair<float, Location>(downCost, down));
-
-        //         // For Incremental searching, which assume the previous grid done the cost calculation
-        //         // this->cached_trace_cost_set(sized_trace_cost_at(up, traceRelativeSearchGrids), up);
-        //     } else {
-        //         // Put in the cache the forbidden flag
-        //         this->cached_via_cost_set(-2, down);
-        //     }
-        // } else {
-        //     // Got a cached via cost value
-        //     downCost += this->cached_via_cost_at(down);
-        //     downCost += GlobalParam::gLayerChangeCost;
-        // }
-
-        //===Original Implementation===
-        if (sizedViaExpandableAndCost(l, viaRelativeSearchGrids, downCost)) {
-            downCost += GlobalParam::gLayerChangeCost;
-            ns.push_back(std::pair<float, Location>(downCost, down));
-
-            // Incremental searching
-            // this->cached_trace_cost_set(sized_trace_cost_at(down, traceRelativeSearchGrids), down);
-        }
-    }
-    */
-
-    // lf
-    if (l.m_x - 1 > -1 && l.m_y + 1 < this->h) {
-        Location lf{l.m_x - 1, l.m_y + 1, l.m_z};
-        float lfCost = GlobalParam::gDiagonalCost;
-
-        if (this->cached_trace_cost_at(lf) == -1) {
-            //lfCost += sized_trace_cost_at(lf, traceSearchRadius);
-            lfCost += sized_trace_cost_at(lf, traceRelativeSearchGrids);
-
-            // Incremental searching
-            // lfCost += currentGridPenalty;
-            // lfCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLFAddGrids());
-            // lfCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLFDedGrids());
-
-            // Put in cache
-            this->cached_trace_cost_set(lfCost - GlobalParam::gDiagonalCost, lf);
-        } else {
-            lfCost += this->cached_trace_cost_at(lf);
-        }
-
-        ns.push_back(std::pair<float, Location>(lfCost, lf));
-    }
-
-    // lb
-    if (l.m_x - 1 > -1 && l.m_y - 1 > -1) {
-        Location lb{l.m_x - 1, l.m_y - 1, l.m_z};
-        float lbCost = GlobalParam::gDiagonalCost;
-
-        if (this->cached_trace_cost_at(lb) == -1) {
-            //lbCost += sized_trace_cost_at(lb, traceSearchRadius);
-            lbCost += sized_trace_cost_at(lb, traceRelativeSearchGrids);
-
-            // Incremental searching
-            // lbCost += currentGridPenalty;
-            // lbCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLBAddGrids());
-            // lbCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getLBDedGrids());
-
-            // Put in cache
-            this->cached_trace_cost_set(lbCost - GlobalParam::gDiagonalCost, lb);
-        } else {
-            lbCost += this->cached_trace_cost_at(lb);
-        }
-
-        ns.push_back(std::pair<float, Location>(lbCost, lb));
-    }
-
-    // rf
-    if (l.m_x + 1 < this->w && l.m_y + 1 < this->h) {
-        Location rf{l.m_x + 1, l.m_y + 1, l.m_z};
-        float rfCost = GlobalParam::gDiagonalCost;
-
-        if (this->cached_trace_cost_at(rf) == -1) {
-            //rfCost += sized_trace_cost_at(rf, traceSearchRadius);
-            rfCost += sized_trace_cost_at(rf, traceRelativeSearchGrids);
-
-            // Incremental searching
-            // rfCost += currentGridPenalty;
-            // rfCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRFAddGrids());
-            // rfCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRFDedGrids());
-
-            // Put in cache
-            this->cached_trace_cost_set(rfCost - GlobalParam::gDiagonalCost, rf);
-        } else {
-            rfCost += this->cached_trace_cost_at(rf);
-        }
-
-        ns.push_back(std::pair<float, Location>(rfCost, rf));
-    }
-
-    // rb
-    if (l.m_x + 1 < this->w && l.m_y - 1 > -1) {
-        Location rb{l.m_x + 1, l.m_y - 1, l.m_z};
-        float rbCost = GlobalParam::gDiagonalCost;
-
-        if (this->cached_trace_cost_at(rb) == -1) {
-            //rbCost += sized_trace_cost_at(rb, traceSearchRadius);
-            rbCost += sized_trace_cost_at(rb, traceRelativeSearchGrids);
-
-            // Incremental searching
-            // rbCost += currentGridPenalty;
-            // rbCost += sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRBAddGrids());
-            // rbCost -= sized_trace_cost_at(l, curGridNetclass.getTraceIncrementalSearchGrids().getRBDedGrids());
-
-            // Put in cache
-            this->cached_trace_cost_set(rbCost - GlobalParam::gDiagonalCost, rb);
-        } else {
-            rbCost += this->cached_trace_cost_at(rb);
-        }
-
-        ns.push_back(std::pair<float, Location>(rbCost, rb));
-    }
 }
 
 void BoardGrid::printGnuPlot() {
     float max_val = 0.0;
     for (int i = 0; i < this->size; i += 1) {
-        if (this->grid[i].baseCost > max_val) max_val = this->grid[i].baseCost;
+        if (this->decodeCost(this->mBaseCostPlane.get(i)) > max_val) max_val = this->decodeCost(this->mBaseCostPlane.get(i));
     }
 
     std::cout << "printGnuPlot()::Max Cost: " << max_val << std::endl;
@@ -1172,10 +1784,11 @@ void BoardGrid::printMatPlot(const std::string fileNameTag) {
     float maxCost = std::numeric_limits<float>::min();
     float minCost = std::numeric_limits<float>::max();
     for (int i = 0; i < this->size; i += 1) {
-        if (this->grid[i].baseCost > maxCost) {
-            maxCost = this->grid[i].baseCost;
-        } else if (this->grid[i].baseCost < minCost) {
-            minCost = this->grid[i].baseCost;
+        float baseCost = this->decodeCost(this->mBaseCostPlane.get(i));
+        if (baseCost > maxCost) {
+            maxCost = baseCost;
+        } else if (baseCost < minCost) {
+            minCost = baseCost;
         }
     }
 
@@ -1279,8 +1892,39 @@ bool BoardGrid::sizedViaExpandableAndCost(const Location &l, const int viaRadius
     return true;
 }
 
+bool BoardGrid::viaFootprintIsClear(const Location &l, const std::vector<Point_2D<int>> &viaRelativeSearchGrids, const int startLayerId, const int endLayerId) const {
+    if (viaRelativeSearchGrids.empty()) {
+        return true;
+    }
+    int minX = viaRelativeSearchGrids.front().x(), maxX = minX;
+    int minY = viaRelativeSearchGrids.front().y(), maxY = minY;
+    for (const auto &gridPt : viaRelativeSearchGrids) {
+        minX = std::min(minX, gridPt.x());
+        maxX = std::max(maxX, gridPt.x());
+        minY = std::min(minY, gridPt.y());
+        maxY = std::max(maxY, gridPt.y());
+    }
+    minX += l.m_x;
+    maxX += l.m_x;
+    minY += l.m_y;
+    maxY += l.m_y;
+    if (minX < 0 || minY < 0 || maxX >= this->w || maxY >= this->h) {
+        return false;
+    }
+    return !this->mViaForbiddenBits.any(minX, maxX, minY, maxY, startLayerId, endLayerId);
+}
+
 bool BoardGrid::sizedViaExpandableAndCost(const Location &l, const std::vector<Point_2D<int>> &viaRelativeSearchGrids, float &cost) const {
     cost = 0.0;
+    if (this->viaFootprintIsClear(l, viaRelativeSearchGrids, 0, this->l - 1)) {
+        // No boundary or via forbidden cells in the footprint's bounding box, only sum up the costs
+        for (int z = 0; z < this->l; ++z) {
+            for (const auto &gridPt : viaRelativeSearchGrids) {
+                cost += this->base_cost_at(Location(l.m_x + gridPt.x(), l.m_y + gridPt.y(), z));
+            }
+        }
+        return true;
+    }
     // Check through hole via
     for (int z = 0; z < this->l; ++z) {
         for (const auto &gridPt : viaRelativeSearchGrids) {
@@ -1305,6 +1949,14 @@ void BoardGrid::sizedViaCostBetweenStartEndLayer(const Location &l, const int st
     cost = 0.0;
     int start = std::min(startLayerId, endLayerId);
     int end = std::max(startLayerId, endLayerId);
+    if (this->viaFootprintIsClear(l, viaRelativeSearchGrids, start, end)) {
+        for (int z = start; z <= end; ++z) {
+            for (const auto &gridPt : viaRelativeSearchGrids) {
+                cost += this->base_cost_at(Location(l.m_x + gridPt.x(), l.m_y + gridPt.y(), z));
+            }
+        }
+        return;
+    }
     // Check through hole via
     for (int z = start; z <= end; ++z) {
         for (const auto &gridPt : viaRelativeSearchGrids) {
@@ -1530,22 +2182,22 @@ void BoardGrid::add_via_cost(const Location &l, const int layer, const float cos
     int radius = viaRadius;
     for (int y = -radius; y <= radius; ++y) {
         for (int x = -radius; x <= radius; ++x) {
+            Location current_l{l.m_x + x, l.m_y + y, layer};
 #ifdef BOUND_CHECKS
-            assert(((l.m_x + x) + (l.m_y + y) * this->w + (layer) * this->w * this->h) < this->size);
+            assert(this->locationToId(current_l) < this->size);
 #endif
-            //this->grid[(l.m_x + x) + (l.m_y + y) * this->w + (layer) * this->w * this->h].viaCost += cost;
-            this->grid[(l.m_x + x) + (l.m_y + y) * this->w + (layer) * this->w * this->h].baseCost += cost;
+            this->addBaseCost(current_l, cost);
         }
     }
 }
 
 void BoardGrid::add_via_cost(const Location &l, const int layer, const float cost, const std::vector<Point_2D<int>> &viaShapeToGrids) {
     for (const auto &relativePt : viaShapeToGrids) {
+        Location current_l{l.m_x + relativePt.x(), l.m_y + relativePt.y(), layer};
 #ifdef BOUND_CHECKS
-        assert(((l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (layer) * this->w * this->h) < this->size);
+        assert(this->locationToId(current_l) < this->size);
 #endif
-        //this->grid[(l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (layer) * this->w * this->h].viaCost += cost;
-        this->grid[(l.m_x + relativePt.x()) + (l.m_y + relativePt.y()) * this->w + (layer) * this->w * this->h].baseCost += cost;
+        this->addBaseCost(current_l, cost);
     }
 }
 
@@ -1882,21 +2534,52 @@ void BoardGrid::backtrackingToGridPath(const Location &end, MultipinRoute &route
     gp.addLocation(end);
     // features.push_back(end);
     Location current = end;
-    int currentId = this->locationToId(current);
-    int nextId = this->getCameFromId(currentId);
-
-    while (nextId != -1) {
-        if (nextId == currentId) {
-            break;
-        }
+    std::uint8_t cameFrom = this->getCameFrom(current);
 
+    // Walk back until the source of the search
+    while (cameFrom != CAME_FROM_NONE && cameFrom != CAME_FROM_SOURCE) {
         Location next;
-        this->idToLocation(nextId, next);
+        SearchWindow::cameFromLocation(current, cameFrom, next);
 
         // features.push_back(next);
         gp.addLocation(next);
-        currentId = nextId;
-        nextId = this->getCameFromId(currentId);
+        current = next;
+        cameFrom = this->getCameFrom(current);
+    }
+
+    std::cout << __FUNCTION__ << ": End of backtracking and create new GridPath" << std::endl;
+}
+
+void BoardGrid::backtrackingBidirectionalToGridPath(const Location &meet, MultipinRoute &route) const {
+    std::cout << __FUNCTION__ << ": Starting backtracking and create new GridPath" << std::endl;
+
+    GridPath &gp = route.getNewGridPath();
+
+    // Target half, walked from meet to the target and added reversed
+    std::vector<Location> targetHalf;
+    Location current = meet;
+    std::uint8_t cameFrom = this->mBackwardSearchWindow.cameFrom(this->mBackwardSearchWindow.id(current));
+    while (cameFrom != CAME_FROM_NONE && cameFrom != CAME_FROM_SOURCE) {
+        Location next;
+        SearchWindow::cameFromLocation(current, cameFrom, next);
+        targetHalf.push_back(next);
+        current = next;
+        cameFrom = this->mBackwardSearchWindow.cameFrom(this->mBackwardSearchWindow.id(current));
+    }
+    for (auto it = targetHalf.rbegin(); it != targetHalf.rend(); ++it) {
+        gp.addLocation(*it);
+    }
+
+    // Source half, as in backtrackingToGridPath()
+    gp.addLocation(meet);
+    current = meet;
+    cameFrom = this->getCameFrom(current);
+    while (cameFrom != CAME_FROM_NONE && cameFrom != CAME_FROM_SOURCE) {
+        Location next;
+        SearchWindow::cameFromLocation(current, cameFrom, next);
+        gp.addLocation(next);
+        current = next;
+        cameFrom = this->getCameFrom(current);
     }
 
     std::cout << __FUNCTION__ << ": End of backtracking and create new GridPath" << std::endl;
@@ -1996,11 +2679,25 @@ void BoardGrid::addRouteWithGridPins(MultipinRoute &route) {
 
     if (route.mGridPins.size() <= 1) return;
 
-    // Clear and initialize
-    this->clearAllCameFromId();
-    this->cached_trace_cost_fill(-1);
-    this->cached_via_cost_fill(-1);
+    // Clear and initialize, O(1) by moving to a new epoch
+    this->resetNetScratch();
     route.currentRouteCost = 0.0;
+    route.mSearchStats = SearchStats();
+    route.orderGridPins(GlobalParam::gPinOrder);
+    // The base costs do not change until the net is routed
+    this->mIncrementalSearchArmed = false;
+    this->mUseTargetDistanceMap = GlobalParam::gTargetDistanceMapBlockSize > 0;
+    if (this->mUseTargetDistanceMap) {
+        this->setupTargetDistanceMap();
+    }
+    this->mUseLandmarks = GlobalParam::gNumLandmarks > 0;
+    if (this->mUseLandmarks && this->mLandmarkTables.empty()) {
+        this->refreshLandmarkTables();
+    }
+    this->mUseJumps = GlobalParam::gJumpSearch;
+    if (this->mUseJumps) {
+        this->setupJumpTiles();
+    }
 
     for (size_t i = 1; i < route.mGridPins.size(); ++i) {
         // For early break
@@ -2012,12 +2709,40 @@ void BoardGrid::addRouteWithGridPins(MultipinRoute &route) {
 
         Location finalEnd{0, 0, 0};
         float routeCost = 0.0;
+        bool found = false;
 
-        this->aStarSearching(route, finalEnd, routeCost);
-        route.currentRouteCost += routeCost;
+        this->startConnectionStats();
+        // Pin to pin, the source is a single pin as well
+        const bool bidirectional = GlobalParam::gBidirectionalSearch && route.getGridPaths().empty();
+        if (bidirectional) {
+            found = this->aStarSearchingBidirectional(route, finalEnd, routeCost);
+        } else {
+            if (this->mUseTargetDistanceMap) {
+                this->buildTargetDistanceMap(route);
+            }
+            if (this->mUseLandmarks) {
+                this->mLandmarkTables.setTargets(this->currentTargetedPinWithLayers);
+            }
+            if (GlobalParam::gIncrementalSearch) {
+                found = this->aStarSearchingIncremental(route, finalEnd, routeCost);
+            } else {
+                found = this->aStarSearching(route, finalEnd, routeCost);
+            }
+        }
+        this->finishConnectionStats(route, found);
+
+        if (!found && this->expansionLimitReached()) {
+            // Leave the pin unconnected, the net is flagged by its statistics
+            std::cout << __FUNCTION__ << "(): net " << route.netId << ", pin " << i << " not connected, search expansion limit (" << GlobalParam::gSearchExpansionLimit << ") reached" << std::endl;
+        } else if (bidirectional) {
+            route.currentRouteCost += routeCost;
+            this->backtrackingBidirectionalToGridPath(finalEnd, route);
+        } else {
+            route.currentRouteCost += routeCost;
 
-        // TODO Fix this, when THROUGH PAD as a start?
-        this->backtrackingToGridPath(finalEnd, route);
+            // TODO Fix this, when THROUGH PAD as a start?
+            this->backtrackingToGridPath(finalEnd, route);
+        }
 
         // Reset temporary stuff
         // For early break
@@ -2032,6 +2757,147 @@ void BoardGrid::addRouteWithGridPins(MultipinRoute &route) {
     this->add_route_to_base_cost(route);
 }
 
+void BoardGrid::setupTargetDistanceMap() {
+    if (this->mTargetDistanceMap.empty()) {
+        int shift = 0;
+        while ((1u << shift) < GlobalParam::gTargetDistanceMapBlockSize) {
+            ++shift;
+        }
+        this->mTargetDistanceMap.setup(this->w, this->h, this->l, shift);
+        // Entering a cell costs at least its own base cost, the trace shape covers it
+        for (int z = 0; z < this->l; ++z) {
+            for (int y = 0; y < this->h; ++y) {
+                for (int x = 0; x < this->w; ++x) {
+                    const Location l{x, y, z};
+                    this->mTargetDistanceMap.lowerBaseCost(l, this->base_cost_at(l));
+                }
+            }
+        }
+        return;
+    }
+
+    // setBaseCost() kept the block minima low enough, only the ones that may have risen are scanned
+    const int blockSize = this->mTargetDistanceMap.blockSize();
+    for (const int id : this->mTargetDistanceMap.staleBlocks()) {
+        const Location origin = this->mTargetDistanceMap.blockOrigin(id);
+        this->mTargetDistanceMap.resetBlock(id);
+        for (int y = origin.m_y; y < std::min(origin.m_y + blockSize, this->h); ++y) {
+            for (int x = origin.m_x; x < std::min(origin.m_x + blockSize, this->w); ++x) {
+                const Location l{x, y, origin.m_z};
+                this->mTargetDistanceMap.lowerBaseCost(l, this->base_cost_at(l));
+            }
+        }
+    }
+    this->mTargetDistanceMap.clearStaleBlocks();
+}
+
+void BoardGrid::refreshLandmarkTables() {
+    int shift = 0;
+    while ((1u << shift) < GlobalParam::gLandmarkBlockSize) {
+        ++shift;
+    }
+    this->mLandmarkTables.setup(this->w, this->h, this->l, shift);
+    for (int z = 0; z < this->l; ++z) {
+        for (int y = 0; y < this->h; ++y) {
+            for (int x = 0; x < this->w; ++x) {
+                const Location l{x, y, z};
+                this->mLandmarkTables.lowerBaseCost(l, this->base_cost_at(l));
+            }
+        }
+    }
+    this->mLandmarkTables.build(GlobalParam::gNumLandmarks, GlobalParam::gLayerChangeCost, GlobalParam::gUseMircoVia);
+    std::cout << __FUNCTION__ << "(): " << this->mLandmarkTables.numLandmarks() << " landmarks over " << this->mLandmarkTables.numBlocks() << " blocks" << std::endl;
+}
+
+void BoardGrid::setupJumpTiles() {
+    if (this->mJumpTileCounts.empty()) {
+        // Tiles cover the trace shapes of all the netclasses plus a cell, 4 cells per side at least
+        int reach = 0;
+        for (const auto &gridNetclass : this->mGridNetclasses) {
+            for (const auto &pt : gridNetclass.getTraceSearchingSpaceToGrids()) {
+                reach = std::max(reach, std::max(abs(pt.x()), abs(pt.y())));
+            }
+        }
+        this->mJumpTileShift = 2;
+        while ((1 << this->mJumpTileShift) < reach + 1) {
+            ++this->mJumpTileShift;
+        }
+        this->mJumpTilesX = ((this->w - 1) >> this->mJumpTileShift) + 1;
+        this->mJumpTilesY = ((this->h - 1) >> this->mJumpTileShift) + 1;
+        this->mJumpTileCounts.assign(this->mJumpTilesX * this->mJumpTilesY * this->l, 0);
+        for (int z = 0; z < this->l; ++z) {
+            for (int y = 0; y < this->h; ++y) {
+                for (int x = 0; x < this->w; ++x) {
+                    const Location l{x, y, z};
+                    if (this->mBaseCostPlane.get(this->locationToId(l)) != 0) {
+                        ++this->mJumpTileCounts[this->jumpTileId(l)];
+                    }
+                }
+            }
+        }
+    }
+
+    // Open tiles: they and the 8 around them are whole on the board, have no base cost and lie in
+    // the search corridor. Runs then stay in the corridor, and the cells along its edges are expanded
+    // one step at a time, so the search turns at its corners.
+    this->mOpenJumpTiles.assign(this->mJumpTileCounts.size(), 0);
+    const int numWholeTilesX = this->w >> this->mJumpTileShift;
+    const int numWholeTilesY = this->h >> this->mJumpTileShift;
+    std::vector<std::uint8_t> inCorridor(this->mJumpTilesX * this->mJumpTilesY, 1);
+    if (this->mUseSearchCorridor) {
+        const int gcellsPerRow = (this->w - 1) / this->mCorridorGCellSize + 1;
+        for (int ty = 0; ty < numWholeTilesY; ++ty) {
+            const int firstRow = this->mCorridorRowOffset[ty << this->mJumpTileShift];
+            const int lastRow = this->mCorridorRowOffset[((ty + 1) << this->mJumpTileShift) - 1];
+            for (int tx = 0; tx < numWholeTilesX; ++tx) {
+                const int firstColumn = this->mCorridorColumn[tx << this->mJumpTileShift];
+                const int lastColumn = this->mCorridorColumn[((tx + 1) << this->mJumpTileShift) - 1];
+                std::uint8_t &in = inCorridor[ty * this->mJumpTilesX + tx];
+                for (int row = firstRow; row <= lastRow && in; row += gcellsPerRow) {
+                    for (int column = firstColumn; column <= lastColumn && in; ++column) {
+                        in = this->mSearchCorridor[row + column];
+                    }
+                }
+            }
+        }
+    }
+    for (int z = 0; z < this->l; ++z) {
+        for (int ty = 1; ty < numWholeTilesY - 1; ++ty) {
+            for (int tx = 1; tx < numWholeTilesX - 1; ++tx) {
+                bool open = true;
+                for (int dy = -1; dy <= 1 && open; ++dy) {
+                    for (int dx = -1; dx <= 1 && open; ++dx) {
+                        open = this->mJumpTileCounts[(z * this->mJumpTilesY + ty + dy) * this->mJumpTilesX + tx + dx] == 0 &&
+                               inCorridor[(ty + dy) * this->mJumpTilesX + tx + dx];
+                    }
+                }
+                this->mOpenJumpTiles[(z * this->mJumpTilesY + ty) * this->mJumpTilesX + tx] = open;
+            }
+        }
+    }
+    // Runs do not change layers, so they only cross the tiles open on the layers a via reaches as well
+    const int numTilesPerLayer = this->mJumpTilesX * this->mJumpTilesY;
+    std::vector<std::uint8_t> openOnLayer = this->mOpenJumpTiles;
+    for (int z = 0; z < this->l; ++z) {
+        for (int nz = 0; nz < this->l; ++nz) {
+            if (nz == z || (GlobalParam::gUseMircoVia && abs(nz - z) != 1)) continue;
+            for (int t = 0; t < numTilesPerLayer; ++t) {
+                this->mOpenJumpTiles[z * numTilesPerLayer + t] &= openOnLayer[nz * numTilesPerLayer + t];
+            }
+        }
+    }
+}
+
+void BoardGrid::buildTargetDistanceMap(const MultipinRoute &route) {
+    // Negative layer preferences would make the layer costs no lower bound
+    std::vector<pr::prIntCost> layerCosts(this->l, 0);
+    const auto &routeLayerCosts = route.getLayerCosts();
+    if (std::none_of(routeLayerCosts.begin(), routeLayerCosts.end(), [](const pr::prIntCost cost) { return cost < 0; })) {
+        std::copy(routeLayerCosts.begin(), routeLayerCosts.begin() + std::min((int)routeLayerCosts.size(), this->l), layerCosts.begin());
+    }
+    this->mTargetDistanceMap.build(this->currentTargetedPinWithLayers, GlobalParam::gLayerChangeCost, layerCosts, GlobalParam::gUseMircoVia);
+}
+
 void BoardGrid::ripup_route(MultipinRoute &route) {
     std::cout << "Doing ripup" << std::endl;
     this->remove_route_from_base_cost(route);
@@ -3,6 +3,9 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -10,17 +13,26 @@
 #include <list>
 #include <queue>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-#include "GridCell.h"
+#include "BucketFrontier.h"
+#include "FrontierHeap.h"
+#include "GridBitPlane.h"
 #include "GridNetclass.h"
 #include "GridPath.h"
 #include "GridPin.h"
+#include "GridPlane.h"
 #include "IncrementalSearchGrids.h"
+#include "LandmarkTables.h"
 #include "Location.h"
 #include "MultipinRoute.h"
+#include "SearchMode.h"
+#include "SearchStats.h"
+#include "SearchWindow.h"
+#include "TargetDistanceMap.h"
 #include "globalParam.h"
 #include "point.h"
 
@@ -34,15 +46,18 @@ class BoardGrid {
     BoardGrid() {}
 
     //dtor
-    ~BoardGrid() {
-        delete[] this->grid;
-        this->grid = nullptr;
-    }
+    ~BoardGrid() {}
     void initilization(int w, int h, int l);
 
     // constraints
     void setCurrentGridNetclassId(const int id) { currentGridNetclassId = id; }
     void setCurrentNetId(const int id) { currentNetId = id; }
+    void setHeuristicWeight(const float weight) { mHeuristicWeight = weight; }
+    // Detailed searches only expand the GCells (gcellSize x gcellSize cells, row-major) set in gcells
+    void setSearchCorridor(const std::vector<std::uint8_t> &gcells, const int gcellSize);
+    void clearSearchCorridor() { mUseSearchCorridor = false; }
+    // Landmark distance tables (GlobalParam::gNumLandmarks) from the current base costs
+    void refreshLandmarkTables();
     void addGridNetclass(const GridNetclass &);
     const GridNetclass &getGridNetclass(const int gridNetclassId);
     // Routing APIs
@@ -86,7 +101,7 @@ class BoardGrid {
     void clearTargetedPins(const std::vector<Location> &pins);
     void setTargetedPin(const Location &l);
     void clearTargetedPin(const Location &l);
-    bool isTargetedPin(const Location &l);
+    bool isTargetedPin(const Location &l) const;
     // via Forbidden
     void setViaForbiddenArea(const std::vector<Location> &locations);
     void clearViaForbiddenArea(const std::vector<Location> &locations);
@@ -108,15 +123,96 @@ class BoardGrid {
     // void print_route(const std::unordered_map<Location, Location> &came_from, const Location &end);
     // void print_features(std::vector<Location> features);
 
+    long long getNumSaturatedCosts() const { return mNumSaturatedCosts; }
+    void showMemoryUsage() const;
+    void showFrontierQoR() const;
+    // What initilization(w, h, l) and a whole board search window allocate with the current options
+    static std::size_t estimateMemoryBytes(const int w, const int h, const int l);
     void showViaCachePerformance() {
         std::cout << "# Via Cost Cached Miss: " << this->viaCachedMissed << std::endl;
         std::cout << "# Via Cost Cached Hit: " << this->viaCachedHit << std::endl;
-        std::cout << "# Via Cost Cached Hit ratio: " << (double)this->viaCachedHit / (this->viaCachedHit + this->viaCachedMissed) << std::endl;
+        if (this->viaCachedHit + this->viaCachedMissed > 0) {
+            std::cout << "# Via Cost Cached Hit ratio: " << (double)this->viaCachedHit / (this->viaCachedHit + this->viaCachedMissed) << std::endl;
+        }
     }
 
    private:
-    GridCell *grid = nullptr;  //Initialize to nullptr
-    int size = 0;              //Total number of cells
+    int size = 0;  //Total number of cells, including the padding of partial tiles
+
+    // Cell addressing behind locationToId()/idToLocation()
+    enum class CellLayout {
+        ROW_MAJOR,               // x + y * w + z * w * h
+        TILED,                   // layer, then xy tile, then row-major inside the tile
+        TILED_LAYER_INTERLEAVED  // xy tile, then layer, then row-major inside the tile
+    };
+    CellLayout mCellLayout = CellLayout::ROW_MAJOR;
+    int mTileShift = 0;  // log2 of the tile edge
+    int mTileMask = 0;
+    int mNumTilesX = 0;
+    int mNumTilesPerLayer = 0;
+    bool mSparse = false;  // Planes allocate one (tile, layer) chunk at a time
+
+    // Structure-of-arrays cell storage, one contiguous plane per field
+    GridPlane<pr::prStoredCost> mBaseCostPlane;         //Record Routed Nets's traces
+    GridPlane<pr::prStoredCost> mCachedTraceCostPlane;  //For incremental cost calculation
+    GridPlane<pr::prStoredCost> mCachedViaCostPlane;    //For incremental cost calculation
+
+    // Epoch stamps validating the cached trace/via costs of the current net. A cell whose stamp
+    // differs from the current epoch reads as uncached, so resetting them between nets is O(1).
+    GridPlane<std::uint16_t> mNetStampPlane;
+    GridBitPlane mViaForbiddenBits;
+    GridBitPlane mTargetedPinBits;
+    std::uint16_t mNetEpoch = 1;
+
+    // Working cost, bending cost and came from code of the current search
+    SearchWindow mSearchWindow;
+    // Open list of the current search, by SearchWindow id
+    FrontierHeap mFrontier;
+    BucketFrontier mBucketFrontier;  // GlobalParam::gBucketFrontier
+    // Search from the targeted pin of a bidirectional search, over the bounds of mSearchWindow
+    SearchWindow mBackwardSearchWindow;
+    FrontierHeap mBackwardFrontier;
+    // Weighted A*: the estimates are scaled by it, paths cost at most this times the optimum
+    float mHeuristicWeight = 1.0;
+    // mSearchWindow and mFrontier hold the search of the previous connection of the net
+    bool mIncrementalSearchArmed = false;
+    // Lower bound of the non-wirelength cost to the targeted pin (GlobalParam::gTargetDistanceMapBlockSize)
+    TargetDistanceMap mTargetDistanceMap;
+    bool mUseTargetDistanceMap = false;
+    // ALT lower bounds of the same cost, tables kept over many nets (GlobalParam::gNumLandmarks)
+    LandmarkTables mLandmarkTables;
+    bool mUseLandmarks = false;
+    // Corridor of the global route of the current net (GlobalGrid)
+    std::vector<std::uint8_t> mSearchCorridor;  // Per GCell
+    std::vector<int> mCorridorColumn;           // Per x, GCell column
+    std::vector<int> mCorridorRowOffset;        // Per y, GCell row * GCells per row
+    int mCorridorGCellSize = 0;
+    bool mUseSearchCorridor = false;
+    // Jump search (GlobalParam::gJumpSearch) over tiles of 2^mJumpTileShift cells per side and layer.
+    // A cell is open when its tile and the 8 around have no base cost, so are its trace costs and the
+    // ones of its neighbours, as long as the tiles are larger than the trace shapes. It has to be open
+    // on the layers a via reaches as well, a run skips the layer changes of the cells it crosses, and
+    // in the search corridor with the tiles around, so runs never leave it.
+    std::vector<int> mJumpTileCounts;          // Per tile, cells of non-zero base cost, updated by setBaseCost() once counted
+    std::vector<std::uint8_t> mOpenJumpTiles;  // Per tile, for the current net
+    int mJumpTileShift = 0;
+    int mJumpTilesX = 0;
+    int mJumpTilesY = 0;
+    bool mUseJumps = false;
+
+    // Bucket queue searches against exact ordering (GlobalParam::gBucketFrontierQoRCheck)
+    int mNumQoRChecks = 0;
+    int mNumQoRWorse = 0;
+    double mQoRCostDelta = 0.0;  // Sum of bucket queue cost - exact cost
+    double mQoRMaxCostDelta = 0.0;
+
+    // Statistics of the searches of the current connection, GlobalParam::gSearchExpansionLimit caps numPops
+    SearchStats mConnectionStats;
+    SearchStats mConnectionStart;  // Counters over all the searches when the connection started
+    std::chrono::steady_clock::time_point mConnectionStartTime;
+
+    float mCostQuantum = 1.0;  // Cost of one stored unit in quantized and fixed point modes
+    long long mNumSaturatedCosts = 0;
 
     long long viaCachedMissed = 0;
     long long viaCachedHit = 0;
@@ -140,14 +236,127 @@ class BoardGrid {
     // trace_width
     float sized_trace_cost_at(const Location &l, const int traceRadius) const;
     float sized_trace_cost_at(const Location &l, const std::vector<Point_2D<int>> &traRelativeSearchGrids) const;
-    // came from id
-    void setCameFromId(const Location &l, const int id);
-    int getCameFromId(const Location &l) const;
-    int getCameFromId(const int id) const;
-    void clearAllCameFromId();
+    // Stored cost encoding, the identity unless built with PCBROUTER_QUANTIZED_COST or PCBROUTER_FIXED_POINT_COST.
+    // Quantized costs are int16 multiples of mCostQuantum, saturating at the int16 range. Fixed point
+    // costs are pr::prCost, saturating at pr::kCostInfinity.
+    void setupCostQuantum();
+    inline pr::prStoredCost encodeCost(const float value) {
+#ifdef PCBROUTER_QUANTIZED_COST
+        float units = std::round(value / this->mCostQuantum);
+        if (units > std::numeric_limits<pr::prStoredCost>::max() || units < std::numeric_limits<pr::prStoredCost>::min()) {
+            ++this->mNumSaturatedCosts;
+            units = std::max(std::min(units, (float)std::numeric_limits<pr::prStoredCost>::max()), (float)std::numeric_limits<pr::prStoredCost>::min());
+        }
+        return (pr::prStoredCost)units;
+#elif defined(PCBROUTER_FIXED_POINT_COST)
+        const pr::prCost units = pr::toCost(value);
+        if (units == pr::kCostInfinity || units == -pr::kCostInfinity) {
+            ++this->mNumSaturatedCosts;
+        }
+        return units;
+#else
+        return value;
+#endif
+    }
+    inline float decodeCost(const pr::prStoredCost value) const {
+#ifdef PCBROUTER_QUANTIZED_COST
+        return value * this->mCostQuantum;
+#elif defined(PCBROUTER_FIXED_POINT_COST)
+        return pr::fromCost(value);
+#else
+        return value;
+#endif
+    }
+    // Cached costs keep the sentinels -1 (not cached) and -2 (via forbidden) exact
+    inline pr::prStoredCost encodeCachedCost(const float value) {
+#ifdef PCBROUTER_QUANTIZED_COST
+        if (value < -1.5) return std::numeric_limits<pr::prStoredCost>::min();
+        if (value < -0.5) return std::numeric_limits<pr::prStoredCost>::min() + 1;
+        return this->encodeCost(std::max(value, (float)0.0));
+#elif defined(PCBROUTER_FIXED_POINT_COST)
+        return this->encodeCost(value);
+#else
+        return value;
+#endif
+    }
+    inline float decodeCachedCost(const pr::prStoredCost value) const {
+#ifdef PCBROUTER_QUANTIZED_COST
+        if (value == std::numeric_limits<pr::prStoredCost>::min()) return -2.0;
+        if (value == std::numeric_limits<pr::prStoredCost>::min() + 1) return -1.0;
+#endif
+        return this->decodeCost(value);
+    }
+    inline void setBaseCost(const Location &l, const pr::prStoredCost value) {
+        pr::prStoredCost &cost = this->mBaseCostPlane[this->locationToId(l)];
+        if (!this->mJumpTileCounts.empty() && (cost != 0) != (value != 0)) {
+            this->mJumpTileCounts[this->jumpTileId(l)] += value != 0 ? 1 : -1;
+        }
+        if (!this->mTargetDistanceMap.empty()) {
+            this->mTargetDistanceMap.updateBaseCost(l, this->decodeCost(cost), this->decodeCost(value));
+        }
+        if (!this->mLandmarkTables.empty()) {
+            this->mLandmarkTables.updateBaseCost(l, this->decodeCost(cost), this->decodeCost(value));
+        }
+        cost = value;
+    }
+    inline void addBaseCost(const Location &l, const float value) {
+#if defined(PCBROUTER_FIXED_POINT_COST) && !defined(PCBROUTER_QUANTIZED_COST)
+        // Integer add of the encoded value, so removing a cost (pins, ripped up routes) restores the cell exactly
+        this->setBaseCost(l, pr::addCost(this->mBaseCostPlane.get(this->locationToId(l)), this->encodeCost(value)));
+#else
+        this->setBaseCost(l, this->encodeCost(this->decodeCost(this->mBaseCostPlane.get(this->locationToId(l))) + value));
+#endif
+    }
+
+    // Scratch epochs
+    void resetNetScratch();
+    void materializeNetScratch();
+    inline void touchNetScratch(const int id) {
+        if (this->mNetStampPlane.get(id) != this->mNetEpoch) {
+            this->mNetStampPlane[id] = this->mNetEpoch;
+            this->mCachedTraceCostPlane[id] = this->encodeCachedCost(-1.0);
+            this->mCachedViaCostPlane[id] = this->encodeCachedCost(-1.0);
+        }
+    }
+    // came from code
+    void setCameFrom(const Location &l, const Location &prev);
+    std::uint8_t getCameFrom(const Location &l) const;
+    void clearAllCameFrom();
     // 2D cost estimation
     float getEstimatedCost(const Location &l);
+    // Octile distance in the given SearchMode, Manhattan without diagonal steps
+    template <typename Mode>
+    float getEstimatedCost(const Location &l, const Location &target) const;
     float getEstimatedCostWithBendingCost(const Location &current, const Location &next);
+    // Block base costs scanned once and kept by setBaseCost(), the distances once per targeted pin
+    void setupTargetDistanceMap();
+    void buildTargetDistanceMap(const MultipinRoute &route);
+    inline float targetDistanceCost(const Location &l) const {
+        const float cost = this->mUseTargetDistanceMap ? this->mTargetDistanceMap.at(l) : 0.0f;
+        return this->mUseLandmarks ? std::max(cost, this->mLandmarkTables.at(l)) : cost;
+    }
+    // Counts the cells of non-zero base cost per jump tile once, and the open cells for the current net
+    void setupJumpTiles();
+    inline int jumpTileId(const Location &l) const {
+        return (l.m_z * this->mJumpTilesY + (l.m_y >> this->mJumpTileShift)) * this->mJumpTilesX + (l.m_x >> this->mJumpTileShift);
+    }
+    inline bool isOpenCell(const Location &l) const { return this->mOpenJumpTiles[this->jumpTileId(l)] != 0; }
+    inline bool onSearchWindowEdge(const Location &l) const {
+        return l.m_x == this->mSearchWindow.minX() || l.m_x == this->mSearchWindow.maxX() || l.m_y == this->mSearchWindow.minY() || l.m_y == this->mSearchWindow.maxY();
+    }
+    inline bool inSearchCorridor(const Location &l) const {
+        return !this->mUseSearchCorridor || this->mSearchCorridor[this->mCorridorRowOffset[l.m_y] + this->mCorridorColumn[l.m_x]];
+    }
+    // Connection statistics, the net's (route.mSearchStats) get the ones of each connection
+    void startConnectionStats();
+    void finishConnectionStats(MultipinRoute &route, const bool found);
+    // The searches of the current connection gave up, growing the window would not help either
+    inline bool expansionLimitReached() const {
+        return GlobalParam::gSearchExpansionLimit > 0 && this->mConnectionStats.numPops >= (long long)GlobalParam::gSearchExpansionLimit;
+    }
+    // Estimate from next to target of a search in the given SearchMode, current being entered with currentCameFrom
+    template <typename Mode>
+    float getEstimatedCostOfNext(const std::uint8_t currentCameFrom, const Location &current, const Location &next, const Location &target) const;
     // 3D cost esitmation
     float getEstimatedCostWithLayers(const Location &current);
     float getEstimatedCostWithLayersAndBendingCost(const Location &current, const Location &next);
@@ -161,20 +370,86 @@ class BoardGrid {
     // std::vector<Location> came_from_to_features(const std::unordered_map<Location, Location> &came_from, const Location &end) const;
     // void came_from_to_features(const Location &end, std::vector<Location> &features) const;
     void backtrackingToGridPath(const Location &end, MultipinRoute &route) const;
+    // Path of a bidirectional search, from the target through meet to the source
+    void backtrackingBidirectionalToGridPath(const Location &meet, MultipinRoute &route) const;
 
-    void getNeighbors(const Location &l, std::vector<std::pair<float, Location>> &ns);
+    // Calls visit(next, nextId, cost) for each neighbour of l in the given SearchMode, nextId being locationToId(next).
+    // cameFrom is l's came from code in the window of the search expanding l.
+    template <typename Mode, typename Visitor>
+    void forEachNeighbor(const Location &l, const std::uint8_t cameFrom, Visitor &&visit);
+    // The layer changes of forEachNeighbor() only
+    template <typename Mode, typename Visitor>
+    void forEachLayerNeighbor(const Location &l, const std::uint8_t cameFrom, Visitor &&visit);
+    // Step cost into the planar neighbour next, its trace obstacle cost is cached per net
+    pr::prCost traceStepCost(const Location &next, const int nextId, const double stepCost, const std::vector<Point_2D<int>> &traceRelativeSearchGrids);
 
     // std::unordered_map<Location, Location> dijkstras_with_came_from(const Location &start, int via_size);
     // std::unordered_map<Location, Location> dijkstras_with_came_from(const std::vector<Location> &route, int via_size);
     // void dijkstras_with_came_from(const std::vector<Location> &route, int via_size, std::unordered_map<Location, Location> &came_from);
     // void dijkstrasWithGridCameFrom(const std::vector<Location> &route, int via_size);
     void aStarWithGridCameFrom(const std::vector<Location> &route, Location &finalEnd, float &finalCost);
-    void aStarSearching(MultipinRoute &route, Location &finalEnd, float &finalCost);
+    template <typename Mode>
+    void aStarWithGridCameFromInMode(const std::vector<Location> &route, Location &finalEnd, float &finalCost);
+    bool aStarSearching(MultipinRoute &route, Location &finalEnd, float &finalCost);
+    // Picks the SearchMode of the current options, the kernels below are instantiated per mode
+    template <typename Frontier>
+    bool aStarSearchingWithFrontier(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost);
+    template <typename Mode, typename Frontier>
+    bool aStarSearchingWithMode(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost);
+    template <typename Mode, typename Frontier>
+    bool aStarSearchingInWindow(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost);
+    // Pops until a targeted pin is at the front, the sources are queued already
+    template <typename Mode, typename Frontier>
+    bool aStarExpandFrontier(MultipinRoute &route, Frontier &frontier, Location &finalEnd, float &finalCost);
+    // Planar expansion of the open cell current by jumps (GlobalParam::gJumpSearch)
+    template <typename Mode, typename Frontier>
+    void aStarJumpFrom(MultipinRoute &route, Frontier &frontier, const Location &current, const int currentWindowId, const bool reopenClosed);
+    // Walks from l along (dx, dy) over open cells, landing on the first targeted pin or cell that is not
+    // open, on the first cell a diagonal (or, in 90-degree mode, straight) walk could turn at towards
+    // one, or two tiles away. False when the walk leaves the search window or corridor first.
+    template <typename Mode>
+    bool jump(const Location &l, const int dx, const int dy, Location &landing, int &steps) const;
+    // Whether a straight walk from the open cell l along (dx, dy) reaches a targeted pin or a cell that
+    // is not open, tile by tile
+    bool scanForLanding(const Location &l, const int dx, const int dy) const;
+    // Resumes the search of the previous connection of the net (GlobalParam::gIncrementalSearch)
+    bool aStarSearchingIncremental(MultipinRoute &route, Location &finalEnd, float &finalCost);
+    template <typename Mode>
+    bool aStarSearchingIncrementalWithMode(MultipinRoute &route, Location &finalEnd, float &finalCost);
+    // Pin to pin search from both ends (GlobalParam::gBidirectionalSearch), meet is a cell of the best path
+    bool aStarSearchingBidirectional(MultipinRoute &route, Location &meet, float &finalCost);
+    template <typename Mode>
+    bool aStarSearchingBidirectionalWithMode(MultipinRoute &route, Location &meet, float &finalCost);
+    template <typename Mode>
+    bool aStarSearchingBidirectionalInWindow(MultipinRoute &route, Location &meet, float &finalCost);
+    // Search window: bounding box of the sources and targets plus a margin, or the whole board
+    void setupSearchWindow(const MultipinRoute &route, const int margin);
+    void setupFullSearchWindow();
+    // Bounding box of all the pins and paths of the net plus a margin, the same for all its connections
+    void setupNetSearchWindow(const MultipinRoute &route, const int margin);
+    bool searchWindowCoversBoard() const;
+    void adviseSearchWindow() const;
 
-    void initializeFrontiers(const std::vector<Location> &route, LocationQueue<Location, float> &frontier);
-    void initializeFrontiers(const MultipinRoute &route, LocationQueue<Location, float> &frontier);
-    void initializeLocationToFrontier(const Location &start, LocationQueue<Location, float> &frontier);
+    // Frontier: FrontierHeap or BucketFrontier
+    template <typename Frontier>
+    void initializeFrontiers(const std::vector<Location> &route, Frontier &frontier);
+    template <typename Frontier>
+    void initializeFrontiers(const MultipinRoute &route, Frontier &frontier);
+    template <typename Frontier>
+    void initializeGridPathToFrontier(const GridPath &gp, Frontier &frontier);
+    template <typename Frontier>
+    void initializeLocationToFrontier(const Location &start, Frontier &frontier);
 
+    void setupCellLayout();
+    bool viaFootprintIsClear(const Location &l, const std::vector<Point_2D<int>> &viaRelativeSearchGrids, const int startLayerId, const int endLayerId) const;
+    template <typename T>
+    void allocatePlane(GridPlane<T> &plane, const T &value) {
+        if (this->mSparse) {
+            plane.allocateSparse(this->size, 2 * this->mTileShift, value);
+        } else {
+            plane.allocate(this->size, value);
+        }
+    }
     int locationToId(const Location &l) const;
     void idToLocation(const int id, Location &l) const;
 };
@@ -0,0 +1,198 @@
+#ifndef PCBROUTER_BUCKET_FRONTIER_H
+#define PCBROUTER_BUCKET_FRONTIER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "GridAllocator.h"
+#include "globalParam.h"
+
+// Monotone radix heap for the A* open list, with the interface of FrontierHeap. Keys are quantized
+// to multiples of a fixed resolution and pops come out in quantized key order, in no particular
+// order within one quantum. Push and pop are amortized O(1): an entry only moves to lower buckets,
+// at most 32 times. Keys below the last popped one break the monotonicity (the bending estimate
+// makes the sources' keys larger than their neighbours'), those go to a small binary heap that is
+// drained first. Updating a queued id leaves its old entry behind, it is dropped at the front.
+class BucketFrontier {
+   public:
+    //ctor
+    BucketFrontier() {}
+    //dtor
+    ~BucketFrontier() {}
+
+    BucketFrontier(const BucketFrontier &) = delete;
+    BucketFrontier &operator=(const BucketFrontier &) = delete;
+
+    void setResolution(const double resolution) {
+        assert(resolution > 0.0);
+        this->mInvResolution = 1.0 / resolution;
+    }
+
+    // Empties the queue for a search over ids [0, numIds)
+    void reset(const int numIds) {
+        for (const auto &entry : this->mUnderflow) {
+            this->mQueued[entry.id] = 0;
+        }
+        this->mUnderflow.clear();
+        for (auto &bucket : this->mBuckets) {
+            for (const auto &entry : bucket) {
+                this->mQueued[entry.id] = 0;
+            }
+            bucket.clear();
+        }
+        if ((std::size_t)numIds > this->mQueued.size()) {
+            this->mKeys.resize(numIds);
+            this->mQuantizedKeys.resize(numIds);
+            this->mQueued.resize(numIds, 0);
+        }
+        this->mLast = 0;
+        this->mNumQueued = 0;
+        this->mFrontInUnderflow = false;
+    }
+
+    inline bool empty() const { return mNumQueued == 0; }
+    inline std::size_t size() const { return mNumQueued; }
+    std::size_t allocatedBytes() const {
+        std::size_t bytes = this->mQueued.size() * (sizeof(pr::prCost) + sizeof(std::uint32_t) + sizeof(std::uint8_t));
+        bytes += this->mUnderflow.capacity() * sizeof(Entry);
+        for (const auto &bucket : this->mBuckets) {
+            bytes += bucket.capacity() * sizeof(Entry);
+        }
+        return bytes;
+    }
+
+    inline std::uint32_t frontId() const { return mFrontInUnderflow ? mUnderflow.front().id : mBuckets[0].back().id; }  // best item
+    inline pr::prCost frontKey() const { return mKeys[this->frontId()]; }  // best item's (exact) key value
+    inline bool contains(const std::uint32_t id) const { return mQueued[id] != 0; }
+
+    // Statistics over all the searches: pushes, entries dropped as outdated by a later push of their
+    // id, and the largest size since resetPeakSize()
+    long long numPushes() const { return mNumPushes; }
+    long long numStalePops() const { return mNumStalePops; }
+    std::size_t peakSize() const { return mPeakSize; }
+    void resetPeakSize() { this->mPeakSize = 0; }
+
+    // Inserts id, or updates its key if it is already queued
+    inline void push(const std::uint32_t id, const pr::prCost key) {
+#ifdef BOUND_CHECKS
+        assert(id < this->mQueued.size());
+#endif
+        ++this->mNumPushes;
+        const std::uint32_t quantizedKey = this->quantize(key);
+        this->mKeys[id] = key;
+        if (this->mQueued[id]) {
+            if (quantizedKey == this->mQuantizedKeys[id]) return;
+        } else {
+            this->mQueued[id] = 1;
+            ++this->mNumQueued;
+            this->mPeakSize = std::max(this->mPeakSize, this->mNumQueued);
+        }
+        this->mQuantizedKeys[id] = quantizedKey;
+        if (quantizedKey < this->mLast) {
+            this->mUnderflow.push_back(Entry{quantizedKey, id});
+            std::push_heap(this->mUnderflow.begin(), this->mUnderflow.end(), isLater);
+        } else {
+            this->mBuckets[this->bucketOf(quantizedKey)].push_back(Entry{quantizedKey, id});
+        }
+        // The entry just replaced may have been the front
+        this->settle();
+    }
+
+    inline void pop() {
+        this->mQueued[this->frontId()] = 0;
+        if (this->mFrontInUnderflow) {
+            std::pop_heap(this->mUnderflow.begin(), this->mUnderflow.end(), isLater);
+            this->mUnderflow.pop_back();
+        } else {
+            this->mBuckets[0].pop_back();
+        }
+        --this->mNumQueued;
+        this->settle();
+    }
+
+   private:
+    struct Entry {
+        std::uint32_t key;  // Quantized
+        std::uint32_t id;
+    };
+
+    static bool isLater(const Entry &a, const Entry &b) { return a.key > b.key; }
+
+    inline std::uint32_t quantize(const pr::prCost key) const {
+        const double units = pr::fromCost(key) * this->mInvResolution + 0.5;
+        if (units <= 0.0) return 0;
+        if (units >= (double)std::numeric_limits<std::uint32_t>::max()) return std::numeric_limits<std::uint32_t>::max();
+        return (std::uint32_t)units;
+    }
+    // 0 for keys equal to mLast, otherwise 1 + the highest bit where the key differs from mLast
+    inline int bucketOf(const std::uint32_t key) const {
+        return key == this->mLast ? 0 : 32 - __builtin_clz(key ^ this->mLast);
+    }
+    inline bool isCurrent(const Entry &entry) const {
+        return this->mQueued[entry.id] && this->mQuantizedKeys[entry.id] == entry.key;
+    }
+
+    // Leaves a current entry at the top of the underflow heap or at the back of bucket 0, unless the queue is empty
+    void settle() {
+        while (!this->mUnderflow.empty() && !this->isCurrent(this->mUnderflow.front())) {
+            std::pop_heap(this->mUnderflow.begin(), this->mUnderflow.end(), isLater);
+            this->mUnderflow.pop_back();
+            ++this->mNumStalePops;
+        }
+        this->mFrontInUnderflow = !this->mUnderflow.empty();
+        while (!this->mFrontInUnderflow && this->mNumQueued > 0) {
+            auto &front = this->mBuckets[0];
+            while (!front.empty() && !this->isCurrent(front.back())) {
+                front.pop_back();
+                ++this->mNumStalePops;
+            }
+            if (!front.empty()) return;
+
+            // Every queued id has a current entry, so a non-empty bucket exists
+            int i = 1;
+            while (this->mBuckets[i].empty()) ++i;
+            auto &bucket = this->mBuckets[i];
+            std::uint32_t minKey = std::numeric_limits<std::uint32_t>::max();
+            bool hasCurrent = false;
+            for (const auto &entry : bucket) {
+                if (this->isCurrent(entry) && entry.key <= minKey) {
+                    minKey = entry.key;
+                    hasCurrent = true;
+                }
+            }
+            if (hasCurrent) {
+                // Redistribute over the lower buckets
+                this->mLast = minKey;
+                for (const auto &entry : bucket) {
+                    if (this->isCurrent(entry)) {
+                        this->mBuckets[this->bucketOf(entry.key)].push_back(entry);
+                    } else {
+                        ++this->mNumStalePops;
+                    }
+                }
+            } else {
+                this->mNumStalePops += bucket.size();
+            }
+            bucket.clear();
+        }
+    }
+
+    double mInvResolution = 16.0;
+    std::uint32_t mLast = 0;  // Quantized key of the last pop from the buckets, no bucket key is below it
+    std::size_t mNumQueued = 0;
+    bool mFrontInUnderflow = false;
+    long long mNumPushes = 0;
+    long long mNumStalePops = 0;
+    std::size_t mPeakSize = 0;
+
+    std::vector<Entry, GridStdAllocator<Entry>> mBuckets[33];
+    std::vector<Entry, GridStdAllocator<Entry>> mUnderflow;  // Min-heap of the keys below mLast
+    std::vector<pr::prCost, GridStdAllocator<pr::prCost>> mKeys;                 // Per id
+    std::vector<std::uint32_t, GridStdAllocator<std::uint32_t>> mQuantizedKeys;  // Per id, of its current entry
+    std::vector<std::uint8_t, GridStdAllocator<std::uint8_t>> mQueued;           // Per id
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef PCBROUTER_FRONTIER_HEAP_H
+#define PCBROUTER_FRONTIER_HEAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "GridAllocator.h"
+#include "globalParam.h"
+
+// Open list of the A* search: an indexed 4-ary min-heap of cell ids (of the SearchWindow) keyed by
+// their f cost. An id is queued at most once, pushing a queued id moves it to its new key instead
+// of adding a duplicate entry. The storage only grows, so the following searches reuse it.
+class FrontierHeap {
+   public:
+    //ctor
+    FrontierHeap() {}
+    //dtor
+    ~FrontierHeap() {}
+
+    FrontierHeap(const FrontierHeap &) = delete;
+    FrontierHeap &operator=(const FrontierHeap &) = delete;
+
+    // Empties the heap for a search over ids [0, numIds)
+    void reset(const int numIds) {
+        // Popped ids are already unmarked, only the ones left by the previous search need it
+        for (const auto &entry : this->mEntries) {
+            this->mPositions[entry.id] = kNotQueued;
+        }
+        this->mEntries.clear();
+        if ((std::size_t)numIds > this->mPositions.size()) {
+            this->mPositions.resize(numIds, kNotQueued);
+        }
+    }
+
+    inline bool empty() const { return mEntries.empty(); }
+    inline std::size_t size() const { return mEntries.size(); }
+    std::size_t allocatedBytes() const {
+        return this->mEntries.capacity() * sizeof(Entry) + this->mPositions.size() * sizeof(std::uint32_t);
+    }
+
+    inline std::uint32_t frontId() const { return mEntries.front().id; }   // best item
+    inline pr::prCost frontKey() const { return mEntries.front().key; }    // best item's key value
+    inline bool contains(const std::uint32_t id) const { return mPositions[id] != kNotQueued; }
+
+    // Statistics over all the searches: pushes, and the largest size since resetPeakSize(). Keys are
+    // updated in place, so no entry gets stale.
+    long long numPushes() const { return mNumPushes; }
+    long long numStalePops() const { return 0; }
+    std::size_t peakSize() const { return mPeakSize; }
+    void resetPeakSize() { this->mPeakSize = 0; }
+
+    // Inserts id, or updates its key if it is already queued
+    inline void push(const std::uint32_t id, const pr::prCost key) {
+#ifdef BOUND_CHECKS
+        assert(id < this->mPositions.size());
+#endif
+        ++this->mNumPushes;
+        std::uint32_t pos = this->mPositions[id];
+        if (pos == kNotQueued) {
+            pos = this->mEntries.size();
+            this->mEntries.push_back(Entry{key, id});
+            this->mPeakSize = std::max(this->mPeakSize, this->mEntries.size());
+            this->siftUp(pos);
+        } else if (key < this->mEntries[pos].key) {
+            this->mEntries[pos].key = key;
+            this->siftUp(pos);
+        } else {
+            this->mEntries[pos].key = key;
+            this->siftDown(pos);
+        }
+    }
+
+    inline void pop() {
+        this->mPositions[this->mEntries.front().id] = kNotQueued;
+        if (this->mEntries.size() > 1) {
+            this->mEntries.front() = this->mEntries.back();
+            this->mEntries.pop_back();
+            this->siftDown(0);
+        } else {
+            this->mEntries.pop_back();
+        }
+    }
+
+    // Recomputes the key of every queued id with key(id) and restores the heap, O(size)
+    template <typename KeyFunction>
+    void rekey(KeyFunction &&key) {
+        for (auto &entry : this->mEntries) {
+            entry.key = key(entry.id);
+        }
+        if (this->mEntries.size() > 1) {
+            for (std::uint32_t pos = (this->mEntries.size() - 2) / 4 + 1; pos-- > 0;) {
+                this->siftDown(pos);
+            }
+        }
+    }
+
+   private:
+    // 8 bytes, the four children of a node span 32 bytes
+    struct Entry {
+        pr::prCost key;
+        std::uint32_t id;
+    };
+    enum : std::uint32_t { kNotQueued = 0xFFFFFFFF };
+
+    inline void place(const std::uint32_t pos, const Entry &entry) {
+        this->mEntries[pos] = entry;
+        this->mPositions[entry.id] = pos;
+    }
+    void siftUp(std::uint32_t pos) {
+        const Entry entry = this->mEntries[pos];
+        while (pos > 0) {
+            const std::uint32_t parent = (pos - 1) >> 2;
+            if (!(entry.key < this->mEntries[parent].key)) break;
+            this->place(pos, this->mEntries[parent]);
+            pos = parent;
+        }
+        this->place(pos, entry);
+    }
+    void siftDown(std::uint32_t pos) {
+        const Entry entry = this->mEntries[pos];
+        const std::uint32_t size = this->mEntries.size();
+        while (true) {
+            const std::uint32_t firstChild = 4 * pos + 1;
+            if (firstChild >= size) break;
+            const std::uint32_t lastChild = std::min(firstChild + 4, size);
+            std::uint32_t best = firstChild;
+            for (std::uint32_t child = firstChild + 1; child < lastChild; ++child) {
+                if (this->mEntries[child].key < this->mEntries[best].key) best = child;
+            }
+            if (!(this->mEntries[best].key < entry.key)) break;
+            this->place(pos, this->mEntries[best]);
+            pos = best;
+        }
+        this->place(pos, entry);
+    }
+
+    std::vector<Entry, GridStdAllocator<Entry>> mEntries;
+    std::vector<std::uint32_t, GridStdAllocator<std::uint32_t>> mPositions;  // Index in mEntries per id
+
+    long long mNumPushes = 0;
+    std::size_t mPeakSize = 0;
+};
+
+#endif
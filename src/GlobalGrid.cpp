@@ -0,0 +1,251 @@
+#include "GlobalGrid.h"
+
+void GlobalGrid::initialization(const int w, const int h, const int gcellSize) {
+    assert(w > 0 && h > 0 && gcellSize > 0);
+    this->mGCellSize = gcellSize;
+    this->mW = (w - 1) / gcellSize + 1;
+    this->mH = (h - 1) / gcellSize + 1;
+    const int numGCells = this->mW * this->mH;
+    this->mCapacity.assign(numGCells, 0.0);
+    this->mDemand.assign(numGCells, 0.0);
+    this->mHistory.assign(numGCells, 0.0);
+    this->mNets.clear();
+    std::cout << __FUNCTION__ << "(): GCell size: " << gcellSize << ", #GCells: " << this->mW << " x " << this->mH << std::endl;
+}
+
+void GlobalGrid::setupCapacity(const BoardGrid &bg, const float obstacleCost) {
+    std::fill(this->mCapacity.begin(), this->mCapacity.end(), 0.0);
+    for (int z = 0; z < bg.l; ++z) {
+        for (int y = 0; y < bg.h; ++y) {
+            for (int x = 0; x < bg.w; ++x) {
+                if (bg.base_cost_at(Location(x, y, z)) < obstacleCost) {
+                    this->mCapacity[this->gcellId(x, y)] += 1.0;
+                }
+            }
+        }
+    }
+    // Free cells / GCell size: average free width across the GCell
+    for (auto &capacity : this->mCapacity) {
+        capacity /= this->mGCellSize;
+    }
+}
+
+void GlobalGrid::addNet(const int netId, const std::vector<Point_2D<int>> &pins, const float demand) {
+    if (netId < 0) return;
+    if (netId >= (int)this->mNets.size()) {
+        this->mNets.resize(netId + 1);
+    }
+    auto &net = this->mNets[netId];
+    net.pins.clear();
+    net.gcells.clear();
+    for (const auto &pin : pins) {
+        const int id = this->gcellId(pin.m_x, pin.m_y);
+        if (std::find(net.pins.begin(), net.pins.end(), id) == net.pins.end()) {
+            net.pins.push_back(id);
+        }
+    }
+    net.demand = std::max(demand, 1.0f);
+}
+
+void GlobalGrid::route(const int numIterations) {
+    this->mPresentFactor = 0.5;
+    for (auto &net : this->mNets) {
+        this->routeNet(net);
+        this->addNetDemand(net, 1.0);
+    }
+
+    for (int i = 0; i < numIterations; ++i) {
+        bool overflowed = false;
+        for (std::size_t id = 0; id < this->mCapacity.size(); ++id) {
+            if (this->mDemand[id] > this->mCapacity[id]) {
+                this->mHistory[id] += 1.0;
+                overflowed = true;
+            }
+        }
+        if (!overflowed) break;
+
+        this->mPresentFactor *= 2.0;
+        int numReroutedNets = 0;
+        for (auto &net : this->mNets) {
+            if (!this->isOverflowed(net)) continue;
+            this->addNetDemand(net, -1.0);
+            this->routeNet(net);
+            this->addNetDemand(net, 1.0);
+            ++numReroutedNets;
+        }
+        std::cout << __FUNCTION__ << "(): iteration " << i + 1 << ", #rerouted nets: " << numReroutedNets << std::endl;
+    }
+}
+
+void GlobalGrid::routeNet(GlobalNet &net) {
+    net.gcells.clear();
+    if (net.pins.empty()) return;
+
+    // Window: bounding box of the pins plus a margin, the costs are finite so a path always exists in it
+    const int windowMargin = 4;
+    int minX = this->mW, maxX = -1, minY = this->mH, maxY = -1;
+    for (const int pin : net.pins) {
+        minX = std::min(minX, pin % this->mW);
+        maxX = std::max(maxX, pin % this->mW);
+        minY = std::min(minY, pin / this->mW);
+        maxY = std::max(maxY, pin / this->mW);
+    }
+    minX = std::max(minX - windowMargin, 0);
+    maxX = std::min(maxX + windowMargin, this->mW - 1);
+    minY = std::max(minY - windowMargin, 0);
+    maxY = std::min(maxY + windowMargin, this->mH - 1);
+    const int windowW = maxX - minX + 1;
+    const int numWindowCells = windowW * (maxY - minY + 1);
+    auto toGCellId = [&](const int windowId) { return (windowId / windowW + minY) * this->mW + windowId % windowW + minX; };
+    auto toWindowId = [&](const int id) { return (id / this->mW - minY) * windowW + id % this->mW - minX; };
+
+    std::vector<std::uint8_t> inTree(numWindowCells, 0);
+    std::vector<std::uint8_t> isRemainingPin(numWindowCells, 0);
+    std::vector<float> cost(numWindowCells);
+    std::vector<int> cameFrom(numWindowCells);
+    std::vector<int> remainingPins;
+    for (const int pin : net.pins) {
+        if (pin == net.pins.front()) continue;
+        remainingPins.push_back(pin);
+        isRemainingPin[toWindowId(pin)] = 1;
+    }
+    inTree[toWindowId(net.pins.front())] = 1;
+    net.gcells.push_back(net.pins.front());
+
+    // Manhattan distance to the nearest unconnected pin, every GCell costs 1 at least
+    auto estimate = [&](const int id) {
+        int distance = std::numeric_limits<int>::max();
+        for (const int pin : remainingPins) {
+            distance = std::min(distance, abs(pin % this->mW - id % this->mW) + abs(pin / this->mW - id / this->mW));
+        }
+        return (float)distance;
+    };
+
+    // Connects the nearest unconnected pin to the tree, until all are
+    while (!remainingPins.empty()) {
+        std::fill(cost.begin(), cost.end(), std::numeric_limits<float>::infinity());
+        this->mFrontier.reset(numWindowCells);
+        for (const int id : net.gcells) {
+            const int windowId = toWindowId(id);
+            cost[windowId] = 0.0;
+            cameFrom[windowId] = -1;
+            this->mFrontier.push(windowId, pr::toCost(estimate(id)));
+        }
+
+        int reachedPin = -1;
+        while (!this->mFrontier.empty()) {
+            const int windowId = this->mFrontier.frontId();
+            this->mFrontier.pop();
+            if (isRemainingPin[windowId]) {
+                reachedPin = windowId;
+                break;
+            }
+            const int x = windowId % windowW;
+            const int y = windowId / windowW;
+            const int neighbors[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+            for (const auto &neighbor : neighbors) {
+                if (neighbor[0] < 0 || neighbor[0] >= windowW || neighbor[1] < 0 || neighbor[1] > maxY - minY) continue;
+                const int nextWindowId = neighbor[1] * windowW + neighbor[0];
+                const int next = toGCellId(nextWindowId);
+                const float newCost = cost[windowId] + this->gcellCost(next, net.demand);
+                if (newCost < cost[nextWindowId]) {
+                    cost[nextWindowId] = newCost;
+                    cameFrom[nextWindowId] = windowId;
+                    this->mFrontier.push(nextWindowId, pr::toCost(newCost + estimate(next)));
+                }
+            }
+        }
+        assert(reachedPin >= 0);
+
+        // Add the path to the tree
+        for (int windowId = reachedPin; windowId >= 0 && !inTree[windowId]; windowId = cameFrom[windowId]) {
+            inTree[windowId] = 1;
+            net.gcells.push_back(toGCellId(windowId));
+        }
+        // The path may pass other pins
+        for (const int pin : remainingPins) {
+            if (inTree[toWindowId(pin)]) {
+                isRemainingPin[toWindowId(pin)] = 0;
+            }
+        }
+        remainingPins.erase(std::remove_if(remainingPins.begin(), remainingPins.end(), [&](const int pin) { return inTree[toWindowId(pin)]; }), remainingPins.end());
+    }
+}
+
+void GlobalGrid::addNetDemand(const GlobalNet &net, const float sign) {
+    for (const int id : net.gcells) {
+        this->mDemand[id] += sign * net.demand;
+    }
+}
+
+bool GlobalGrid::isOverflowed(const GlobalNet &net) const {
+    for (const int id : net.gcells) {
+        if (this->mDemand[id] > this->mCapacity[id]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GlobalGrid::getCorridor(const int netId, const int margin, std::vector<std::uint8_t> &gcells) const {
+    gcells.assign(this->mCapacity.size(), 0);
+    if (netId < 0 || netId >= (int)this->mNets.size()) return;
+    for (const int id : this->mNets[netId].gcells) {
+        const int x = id % this->mW;
+        const int y = id / this->mW;
+        for (int ny = std::max(y - margin, 0); ny <= std::min(y + margin, this->mH - 1); ++ny) {
+            for (int nx = std::max(x - margin, 0); nx <= std::min(x + margin, this->mW - 1); ++nx) {
+                gcells[ny * this->mW + nx] = 1;
+            }
+        }
+    }
+}
+
+void GlobalGrid::showCongestion() const {
+    int numOverflowed = 0;
+    double totalOverflow = 0.0;
+    double maxUtilization = 0.0;
+    for (std::size_t id = 0; id < this->mCapacity.size(); ++id) {
+        if (this->mDemand[id] > this->mCapacity[id]) {
+            ++numOverflowed;
+            totalOverflow += this->mDemand[id] - this->mCapacity[id];
+        }
+        if (this->mCapacity[id] > 0.0) {
+            maxUtilization = std::max(maxUtilization, (double)this->mDemand[id] / this->mCapacity[id]);
+        }
+    }
+    std::cout << "# GCells: " << this->mCapacity.size() << std::endl;
+    std::cout << "# Overflowed GCells: " << numOverflowed << std::endl;
+    std::cout << "# Total overflow (cells): " << totalOverflow << std::endl;
+    std::cout << "# Max utilization: " << maxUtilization << std::endl;
+}
+
+void GlobalGrid::printCongestionMap(const std::string fileNameTag) const {
+    std::string outFileName = fileNameTag + ".congestion.py";
+    outFileName = util::appendDirectory(GlobalParam::gOutputFolder, outFileName);
+    std::ofstream ofs(outFileName, std::ofstream::out);
+    std::cout << "outFileName: " << outFileName << std::endl;
+
+    // Demand / capacity per GCell
+    ofs << std::fixed << std::setprecision(5);
+    ofs << "import numpy as np\n";
+    ofs << "import matplotlib.pyplot as plt\n";
+    ofs << "plt.close()\n";
+    ofs << "data = np.array([";
+    for (int y = 0; y < this->mH; ++y) {
+        ofs << "[";
+        for (int x = 0; x < this->mW; ++x) {
+            const int id = y * this->mW + x;
+            const float utilization = this->mCapacity[id] > 0.0 ? this->mDemand[id] / this->mCapacity[id] : (this->mDemand[id] > 0.0 ? 2.0 : 0.0);
+            ofs << utilization << (x < this->mW - 1 ? ", " : "]");
+        }
+        ofs << (y < this->mH - 1 ? ", " : "");
+    }
+    ofs << "])\n";
+    ofs << "plt.pcolormesh(data, cmap=plt.get_cmap('RdYlGn_r'), vmin=0.0, vmax=2.0)\n";
+    ofs << "plt.title('GCell utilization')\n";
+    ofs << "plt.colorbar()\n";
+    ofs << "plt.axis('equal')\n";
+    ofs << "plt.gca().invert_yaxis()\n";
+    ofs << "plt.show()\n";
+}
@@ -0,0 +1,83 @@
+#ifndef PCBROUTER_GLOBAL_GRID_H
+#define PCBROUTER_GLOBAL_GRID_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "BoardGrid.h"
+#include "FrontierHeap.h"
+#include "globalParam.h"
+#include "point.h"
+#include "util.h"
+
+// Coarse grid of GCells, each gcellSize x gcellSize BoardGrid cells over all the layers, for global
+// routing. Nets are routed over the GCells with a capacity based congestion cost and negotiate the
+// overflow over a few rip-up and re-route iterations (history costs, as in PathFinder). The GCells
+// of a net's global route, dilated by a margin, make the corridor of its detailed searches.
+class GlobalGrid {
+   public:
+    //ctor
+    GlobalGrid() {}
+    //dtor
+    ~GlobalGrid() {}
+
+    // Over a w x h BoardGrid
+    void initialization(const int w, const int h, const int gcellSize);
+    bool empty() const { return mCapacity.empty(); }
+    int getGCellSize() const { return mGCellSize; }
+    int getWidth() const { return mW; }
+    int getHeight() const { return mH; }
+    inline int gcellId(const int x, const int y) const { return (y / this->mGCellSize) * this->mW + x / this->mGCellSize; }
+
+    // Capacity of a GCell: the free track width across it, in cells summed over the layers. Cells
+    // whose base cost reaches obstacleCost are blocked.
+    void setupCapacity(const BoardGrid &bg, const float obstacleCost);
+    // Pins are BoardGrid xy, demand is the track width the net takes: trace width + clearance
+    void addNet(const int netId, const std::vector<Point_2D<int>> &pins, const float demand);
+    // Routes all the nets, then reroutes the ones through overflowed GCells numIterations times at most
+    void route(const int numIterations);
+
+    // Per GCell, 1 for the GCells within margin of the global route of the net
+    void getCorridor(const int netId, const int margin, std::vector<std::uint8_t> &gcells) const;
+
+    // Congestion map
+    void showCongestion() const;
+    void printCongestionMap(const std::string fileNameTag = "") const;
+
+   private:
+    struct GlobalNet {
+        std::vector<int> pins;    // GCell ids, unique
+        std::vector<int> gcells;  // GCell ids of the global route
+        float demand = 0.0;
+    };
+
+    void routeNet(GlobalNet &net);
+    void addNetDemand(const GlobalNet &net, const float sign);
+    bool isOverflowed(const GlobalNet &net) const;
+    // Cost of entering GCell id with a net of the given demand
+    inline float gcellCost(const int id, const float demand) const {
+        const float overflow = std::max(this->mDemand[id] + demand - this->mCapacity[id], 0.0f) / demand;  // In nets
+        return (1.0f + this->mHistory[id]) * (1.0f + this->mPresentFactor * overflow);
+    }
+
+    int mGCellSize = 1;
+    int mW = 0;  // GCells per row
+    int mH = 0;  // GCells per column
+
+    std::vector<float> mCapacity;  // Per GCell
+    std::vector<float> mDemand;    // Per GCell
+    std::vector<float> mHistory;   // Per GCell, grows while the GCell stays overflowed
+    float mPresentFactor = 0.5;
+
+    std::vector<GlobalNet> mNets;  // By net id
+    FrontierHeap mFrontier;
+};
+
+#endif
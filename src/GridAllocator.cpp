@@ -0,0 +1,219 @@
+#include "GridAllocator.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "globalParam.h"
+
+namespace {
+// Default huge page size on x86-64 and most aarch64 kernels
+const std::size_t kHugePageSize = 2 * 1024 * 1024;
+// From <numaif.h>, which isn't installed everywhere
+const int kMpolInterleave = 3;
+}  // namespace
+
+std::size_t GridAllocator::sBytes[4] = {0, 0, 0, 0};
+std::size_t GridAllocator::sNumaInterleavedBytes = 0;  // Currently allocated
+std::unordered_map<void *, GridAllocation> GridAllocator::sBuffers;
+
+GridAllocation GridAllocator::allocate(const std::size_t bytes) {
+    if (!GlobalParam::gGridMmapDirectory.empty()) {
+        GridAllocation allocation = allocateMapped(bytes, GlobalParam::gGridMmapDirectory);
+        if (allocation.ptr) {
+            return allocation;
+        }
+        std::cerr << __FUNCTION__ << "(): Failed to map " << bytes << " bytes in " << GlobalParam::gGridMmapDirectory
+                  << ", falling back to anonymous memory" << std::endl;
+    }
+    return allocateAnonymous(bytes);
+}
+
+void *GridAllocator::allocateBuffer(const std::size_t bytes) {
+    GridAllocation allocation = allocateAnonymous(bytes);
+    if (allocation.backing != GridBacking::HEAP) {
+        sBuffers[allocation.ptr] = allocation;
+    }
+    return allocation.ptr;
+}
+
+void GridAllocator::releaseBuffer(void *ptr, const std::size_t bytes) {
+    auto ite = sBuffers.find(ptr);
+    if (ite != sBuffers.end()) {
+        release(ite->second);
+        sBuffers.erase(ite);
+        return;
+    }
+    GridAllocation allocation;
+    allocation.ptr = ptr;
+    allocation.bytes = bytes;
+    release(allocation);
+}
+
+GridAllocation GridAllocator::allocateHeap(const std::size_t bytes) {
+    GridAllocation allocation;
+    allocation.ptr = std::malloc(bytes);
+    if (!allocation.ptr && bytes > 0) {
+        throw std::bad_alloc();
+    }
+    allocation.bytes = bytes;
+    sBytes[(int)GridBacking::HEAP] += bytes;
+    return allocation;
+}
+
+GridAllocation GridAllocator::allocateAnonymous(const std::size_t bytes) {
+    // Small blocks gain nothing from huge pages or interleaving
+    if (bytes < kHugePageSize || (!GlobalParam::gGridHugePages && !GlobalParam::gGridNumaInterleave)) {
+        return allocateHeap(bytes);
+    }
+    GridAllocation allocation;
+    const std::size_t length = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (GlobalParam::gGridHugePages) {
+        // Fails unless huge pages are reserved (vm.nr_hugepages)
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            allocation.backing = GridBacking::HUGETLB;
+        }
+    }
+#endif
+    if (ptr == MAP_FAILED) {
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            std::cerr << __FUNCTION__ << "(): mmap: " << strerror(errno) << ", falling back to the heap" << std::endl;
+            return allocateHeap(bytes);
+        }
+        allocation.backing = GridBacking::ANONYMOUS;
+#ifdef MADV_HUGEPAGE
+        if (GlobalParam::gGridHugePages) {
+            madvise(ptr, length, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    allocation.ptr = ptr;
+    allocation.bytes = length;
+    sBytes[(int)allocation.backing] += length;
+    // Before the first touch, so that it decides the placement
+    applyNumaPolicy(allocation);
+    return allocation;
+}
+
+GridAllocation GridAllocator::allocateMapped(const std::size_t bytes, const std::string &directory) {
+    GridAllocation allocation;
+    std::string pathTemplate = directory + "/pcbrouter_grid_XXXXXX";
+    std::vector<char> path(pathTemplate.begin(), pathTemplate.end());
+    path.push_back('\0');
+
+    int fd = mkstemp(path.data());
+    if (fd == -1) {
+        std::cerr << __FUNCTION__ << "(): mkstemp: " << strerror(errno) << std::endl;
+        return allocation;
+    }
+    // The mapping keeps the file alive, nothing is left behind when the process exits
+    unlink(path.data());
+    if (ftruncate(fd, bytes) == -1) {
+        std::cerr << __FUNCTION__ << "(): ftruncate: " << strerror(errno) << std::endl;
+        close(fd);
+        return allocation;
+    }
+    void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        std::cerr << __FUNCTION__ << "(): mmap: " << strerror(errno) << std::endl;
+        return allocation;
+    }
+    // Accesses follow the search, not the file order, so don't read ahead
+    madvise(ptr, bytes, MADV_RANDOM);
+
+    allocation.ptr = ptr;
+    allocation.bytes = bytes;
+    allocation.backing = GridBacking::FILE;
+    sBytes[(int)GridBacking::FILE] += bytes;
+    return allocation;
+}
+
+void GridAllocator::release(GridAllocation &allocation) {
+    if (allocation.backing == GridBacking::HEAP) {
+        std::free(allocation.ptr);
+    } else {
+        munmap(allocation.ptr, allocation.bytes);
+    }
+    sBytes[(int)allocation.backing] -= allocation.bytes;
+    if (allocation.numaInterleaved) {
+        sNumaInterleavedBytes -= allocation.bytes;
+    }
+    allocation = GridAllocation();
+}
+
+void GridAllocator::adviseWillNeed(const GridAllocation &allocation, const std::size_t offset, const std::size_t bytes) {
+    if (allocation.backing != GridBacking::FILE || bytes == 0) {
+        return;
+    }
+    // madvise() takes page aligned ranges
+    static const std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    std::size_t begin = offset / pageSize * pageSize;
+    std::size_t end = std::min(offset + bytes, allocation.bytes);
+    madvise(static_cast<char *>(allocation.ptr) + begin, end - begin, MADV_WILLNEED);
+}
+
+void GridAllocator::applyNumaPolicy(GridAllocation &allocation) {
+    if (!GlobalParam::gGridNumaInterleave) {
+        return;
+    }
+#if defined(__linux__) && defined(SYS_mbind)
+    const int numNodes = numNumaNodes();
+    if (numNodes < 2) {
+        return;
+    }
+    std::vector<unsigned long> nodeMask((numNodes + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long)), 0);
+    for (int node = 0; node < numNodes; ++node) {
+        nodeMask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    }
+    if (syscall(SYS_mbind, allocation.ptr, allocation.bytes, kMpolInterleave, nodeMask.data(), numNodes + 1, 0) == 0) {
+        sNumaInterleavedBytes += allocation.bytes;
+        allocation.numaInterleaved = true;
+    } else {
+        std::cerr << __FUNCTION__ << "(): mbind: " << strerror(errno) << std::endl;
+    }
+#endif
+}
+
+int GridAllocator::numNumaNodes() {
+    // "0" or "0-3" (holes in the numbering are not handled, they would only lose some nodes)
+    static int numNodes = -1;
+    if (numNodes < 0) {
+        numNodes = 1;
+        std::ifstream ifs("/sys/devices/system/node/online");
+        std::string online;
+        if (ifs >> online) {
+            std::string::size_type pos = online.find_last_of("-,");
+            numNodes = atoi(online.substr(pos == std::string::npos ? 0 : pos + 1).c_str()) + 1;
+        }
+    }
+    return numNodes;
+}
+
+void GridAllocator::showPolicy() {
+    std::string thpMode = "unavailable";
+    std::ifstream ifs("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::getline(ifs, thpMode);
+    const double MB = 1024.0 * 1024.0;
+    std::cout << "GridAllocator: huge pages: " << (GlobalParam::gGridHugePages ? "requested" : "off")
+              << " (transparent huge pages: " << thpMode << ")"
+              << ", NUMA: " << (GlobalParam::gGridNumaInterleave ? "interleave" : "first touch") << " over " << numNumaNodes() << " node(s)" << std::endl;
+    std::cout << "GridAllocator: heap: " << sBytes[(int)GridBacking::HEAP] / MB << " MB"
+              << ", MAP_HUGETLB: " << sBytes[(int)GridBacking::HUGETLB] / MB << " MB"
+              << ", anonymous (MADV_HUGEPAGE " << (GlobalParam::gGridHugePages ? "on" : "off") << "): " << sBytes[(int)GridBacking::ANONYMOUS] / MB << " MB"
+              << ", file-backed: " << sBytes[(int)GridBacking::FILE] / MB << " MB"
+              << ", NUMA interleaved: " << sNumaInterleavedBytes / MB << " MB" << std::endl;
+}
@@ -0,0 +1,76 @@
+#ifndef PCBROUTER_GRID_ALLOCATOR_H
+#define PCBROUTER_GRID_ALLOCATOR_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+enum class GridBacking {
+    HEAP,       // malloc
+    ANONYMOUS,  // Anonymous mapping, transparent huge pages requested by madvise
+    HUGETLB,    // Anonymous mapping from the reserved huge page pool
+    FILE        // Shared mapping of an unlinked file
+};
+
+// One block of grid storage
+struct GridAllocation {
+    void *ptr = nullptr;
+    std::size_t bytes = 0;  // Length of the block or of its mapping
+    GridBacking backing = GridBacking::HEAP;
+    bool numaInterleaved = false;
+};
+
+// Backing store of the BoardGrid planes and the search buffers. By default blocks come from the heap.
+// - GlobalParam::gGridMmapDirectory: planes are shared mappings of unlinked files in that directory,
+//   so the kernel can write cold pages back to disk instead of running out of memory.
+// - GlobalParam::gGridHugePages: blocks of at least one huge page are anonymous mappings from the
+//   MAP_HUGETLB pool, or with MADV_HUGEPAGE if the pool is empty, to cut TLB misses.
+// - GlobalParam::gGridNumaInterleave: anonymous mappings are interleaved over all NUMA nodes.
+//   Otherwise pages are placed on the node that first touches them.
+class GridAllocator {
+   public:
+    // Grid planes, may be file-backed
+    static GridAllocation allocate(const std::size_t bytes);
+    static void release(GridAllocation &allocation);
+
+    // Search buffers (frontier, search window), never file-backed
+    static void *allocateBuffer(const std::size_t bytes);
+    static void releaseBuffer(void *ptr, const std::size_t bytes);
+
+    // Hints for file-backed blocks, no-ops for the others
+    static void adviseWillNeed(const GridAllocation &allocation, const std::size_t offset, const std::size_t bytes);
+
+    static std::size_t mappedBytes() { return sBytes[(int)GridBacking::FILE]; }
+    static void showPolicy();
+
+   private:
+    static GridAllocation allocateMapped(const std::size_t bytes, const std::string &directory);
+    static GridAllocation allocateAnonymous(const std::size_t bytes);
+    static GridAllocation allocateHeap(const std::size_t bytes);
+    static void applyNumaPolicy(GridAllocation &allocation);
+    static int numNumaNodes();
+
+    static std::size_t sBytes[4];  // Currently allocated, per GridBacking
+    static std::size_t sNumaInterleavedBytes;
+    static std::unordered_map<void *, GridAllocation> sBuffers;  // Mapped search buffers
+};
+
+// std allocator adaptor, for the vectors of the search structures
+template <typename T>
+struct GridStdAllocator {
+    using value_type = T;
+
+    GridStdAllocator() {}
+    template <typename U>
+    GridStdAllocator(const GridStdAllocator<U> &) {}
+
+    T *allocate(const std::size_t n) { return static_cast<T *>(GridAllocator::allocateBuffer(n * sizeof(T))); }
+    void deallocate(T *ptr, const std::size_t n) { GridAllocator::releaseBuffer(ptr, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const GridStdAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const GridStdAllocator<U> &) const { return false; }
+};
+
+#endif
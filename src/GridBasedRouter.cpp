@@ -411,6 +411,114 @@ void GridBasedRouter::setupGridNetclass() {
     }
 }
 
+void GridBasedRouter::selectGridScale() {
+    if (GlobalParam::gMemoryBudgetMB <= 0.0 && GlobalParam::gTimeBudget <= 0.0) {
+        return;
+    }
+    std::cout << "\n\n######Start of " << __FUNCTION__ << "()" << std::endl;
+    // Rough cost of one A* expansion (pop, neighbours, pushes), for the time estimate only
+    const double kSecondsPerExpansion = 2e-7;
+
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    mDb.getBoardBoundaryByEdgeCuts(minX, maxX, minY, maxY);
+    const int l = mDb.getNumCopperLayers();
+    const int numRoutings = GlobalParam::gNumRipUpReRouteIteration + 1;
+    // Copies of the nets: mGridNets, bestSolution and one per routing in routingSolutions
+    const int numNetCopies = numRoutings + 2;
+
+    // Pin shapes are expanded by the largest obstacle expansion of the netclasses
+    double dbExpansion = 0.0;
+    for (auto &netclassIte : mDb.getNetclasses()) {
+        dbExpansion = std::max(dbExpansion, netclassIte.getClearance() + netclassIte.getTraceWidth() / 2.0);
+    }
+
+    // Scale independent sizes in db units
+    std::vector<Point_2D<double>> instancePadSizes;  // mGridPins
+    std::vector<Point_2D<double>> netPadSizes;       // The GridPins of the nets
+    std::vector<Point_2D<double>> netBoxSizes;       // Bounding boxes of the nets' pins
+    for (auto &inst : mDb.getInstances()) {
+        if (!mDb.isComponentId(inst.getComponentId())) {
+            continue;
+        }
+        for (auto &pad : mDb.getComponent(inst.getComponentId()).getPadstacks()) {
+            double width = 0, height = 0;
+            mDb.getPadstackRotatedWidthAndHeight(inst, pad, width, height);
+            instancePadSizes.push_back(Point_2D<double>{width, height});
+        }
+    }
+    for (auto &net : mDb.getNets()) {
+        Point_2D<double> boxLL{std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        Point_2D<double> boxUR{std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+        for (auto &pin : net.getPins()) {
+            auto &comp = mDb.getComponent(pin.getCompId());
+            auto &inst = mDb.getInstance(pin.getInstId());
+            auto &pad = comp.getPadstack(pin.getPadstackId());
+            Point_2D<double> pinDbLocation;
+            mDb.getPinPosition(pad, inst, &pinDbLocation);
+            boxLL.m_x = std::min(boxLL.m_x, pinDbLocation.m_x);
+            boxLL.m_y = std::min(boxLL.m_y, pinDbLocation.m_y);
+            boxUR.m_x = std::max(boxUR.m_x, pinDbLocation.m_x);
+            boxUR.m_y = std::max(boxUR.m_y, pinDbLocation.m_y);
+            double width = 0, height = 0;
+            mDb.getPadstackRotatedWidthAndHeight(inst, pad, width, height);
+            netPadSizes.push_back(Point_2D<double>{width, height});
+        }
+        if (net.getPins().size() >= 2) {
+            netBoxSizes.push_back(Point_2D<double>{boxUR.m_x - boxLL.m_x, boxUR.m_y - boxLL.m_y});
+        }
+    }
+
+    // Try the scales from the finest (the configured one) down, keep the first that fits the budgets
+    const unsigned int maxScale = std::max(1u, GlobalParam::inputScale);
+    unsigned int selectedScale = 1;
+    for (unsigned int scale = maxScale; scale >= 1; --scale) {
+        const int h = int(std::abs(maxY * scale - minY * scale)) + GlobalParam::enlargeBoundary;
+        const int w = int(std::abs(maxX * scale - minX * scale)) + GlobalParam::enlargeBoundary;
+        const double expansion = 2.0 * std::ceil(dbExpansion * scale);
+
+        const double gridBytes = (double)BoardGrid::estimateMemoryBytes(w, h, l);
+        double instancePinBytes = 0.0;
+        for (auto &size : instancePadSizes) {
+            instancePinBytes += (size.m_x * scale + expansion + 1.0) * (size.m_y * scale + expansion + 1.0) * sizeof(Point_2D<int>);
+        }
+        double netPinBytes = 0.0;
+        for (auto &size : netPadSizes) {
+            netPinBytes += (size.m_x * scale + expansion + 1.0) * (size.m_y * scale + expansion + 1.0) * sizeof(Point_2D<int>);
+        }
+        // Paths about as long as the half perimeters, stored as features and as segments
+        double pathBytes = 0.0;
+        double numExpansions = 0.0;
+        for (auto &size : netBoxSizes) {
+            pathBytes += (size.m_x + size.m_y) * scale * 2.0 * sizeof(Location);
+            numExpansions += (size.m_x * scale + 1.0) * (size.m_y * scale + 1.0) * l;
+        }
+        const double historyBytes = numNetCopies * (netPinBytes + pathBytes);
+        const double totalMB = (gridBytes + instancePinBytes + historyBytes) / 1048576.0;
+        const double seconds = numExpansions * numRoutings * kSecondsPerExpansion;
+
+        std::cout << "inputScale: " << scale << ", BoardGrid w:" << w << ", h:" << h << ", l:" << l
+                  << ", estimated memory: " << totalMB << " MB (grid: " << gridBytes / 1048576.0
+                  << " MB, pin shapes: " << instancePinBytes / 1048576.0 << " MB, solution history: " << historyBytes / 1048576.0
+                  << " MB), estimated search: " << numExpansions * numRoutings << " expansions, ~" << seconds << " s" << std::endl;
+
+        const bool fitsMemory = GlobalParam::gMemoryBudgetMB <= 0.0 || totalMB <= GlobalParam::gMemoryBudgetMB;
+        const bool fitsTime = GlobalParam::gTimeBudget <= 0.0 || seconds <= GlobalParam::gTimeBudget;
+        if (fitsMemory && fitsTime) {
+            selectedScale = scale;
+            break;
+        }
+        if (scale == 1) {
+            std::cerr << __FUNCTION__ << "(): No inputScale fits the budgets (memory: " << GlobalParam::gMemoryBudgetMB
+                      << " MB, time: " << GlobalParam::gTimeBudget << " s), using 1" << std::endl;
+        }
+    }
+
+    GlobalParam::inputScale = selectedScale;
+    GlobalParam::gridFactor = 1.0 / (float)GlobalParam::inputScale;
+    std::cout << "Selected inputScale: " << GlobalParam::inputScale << " (finest: " << maxScale << ")" << std::endl;
+    std::cout << "######End of " << __FUNCTION__ << "()\n\n";
+}
+
 void GridBasedRouter::setupBoardGrid() {
     std::cout << "\n\n######Start of " << __FUNCTION__ << "()" << std::endl;
     // Get board dimension
@@ -625,6 +733,8 @@ void GridBasedRouter::set_net_all_layers_pref_weights(const int _netId, const in
 void GridBasedRouter::initialization() {
     // Initilization
     this->setupLayerMapping();
+    // Before anything is sized by inputScale
+    this->selectGridScale();
     this->setupGridNetclass();
     this->setupBoardGrid();
     this->setupGridNetsAndGridPins();
@@ -643,7 +753,18 @@ void GridBasedRouter::route() {
     std::string initialMapNameTag = util::getFileNameWoExtension(mDb.getFileName()) + ".initial" + this->getParamsNameTag();
     mBg.printMatPlot(initialMapNameTag);
 
+    // Corridors of the detailed searches
+    if (GlobalParam::gGlobalRoutingGCellSize > 0.0) {
+        this->globalRouting();
+    } else {
+        mBg.clearSearchCorridor();
+    }
+
     // Add all nets to grid routes
+    mBg.setHeuristicWeight(this->getHeuristicWeight(0));
+    // Per net over all the iterations, and per iteration
+    std::vector<SearchStats> netSearchStats(this->mGridNets.size());
+    SearchStats iterationSearchStats;
     double totalCurrentRouteCost = 0.0;
     bestTotalRouteCost = 0.0;
     auto &nets = mDb.getNets();
@@ -679,9 +800,11 @@ void GridBasedRouter::route() {
         gridRoute.setCurTrackObstacleCost(GlobalParam::gTraceBasicCost);
         gridRoute.setCurViaObstacleCost(GlobalParam::gViaInsertionCost);
         mBg.setCurrentNetId(net.getId());
+        this->setupSearchCorridor(net.getId());
 
         // Route the net
         mBg.addRouteWithGridPins(gridRoute);
+        this->addNetSearchStats(gridRoute, iterationSearchStats, netSearchStats);
         totalCurrentRouteCost += gridRoute.currentRouteCost;
         std::cout << "=====> currentRouteCost: " << gridRoute.currentRouteCost << ", totalCost: " << totalCurrentRouteCost << std::endl;
 
@@ -705,11 +828,19 @@ void GridBasedRouter::route() {
         writeSolutionBackToDbAndSaveOutput(nameTag, this->mGridNets);
     }
     std::cout << "i=0, totalCurrentRouteCost: " << totalCurrentRouteCost << ", bestTotalRouteCost: " << bestTotalRouteCost << std::endl;
+    this->showSearchStats("i=0", iterationSearchStats);
 
     std::cout << "\n\n======= Start Fixed-Order Rip-Up and Re-Route all nets. =======\n\n";
 
     // Rip-up and Re-route all the nets one-by-one ten times
     for (int i = 0; i < static_cast<int>(GlobalParam::gNumRipUpReRouteIteration); ++i) {
+        mBg.setHeuristicWeight(this->getHeuristicWeight(i + 1));
+        std::cout << "i=" << i + 1 << ", heuristic weight: " << this->getHeuristicWeight(i + 1) << std::endl;
+        // Lower bounds from the base costs the previous iteration left
+        if (GlobalParam::gNumLandmarks > 0) {
+            mBg.refreshLandmarkTables();
+        }
+        iterationSearchStats = SearchStats();
         for (auto &net : nets) {
             //continue;
             if (net.getPins().size() < 2)
@@ -738,7 +869,9 @@ void GridBasedRouter::route() {
 
             gridRoute.addCurTrackObstacleCost(GlobalParam::gStepTraObsCost);
             gridRoute.addCurViaObstacleCost(GlobalParam::gStepViaObsCost);
+            this->setupSearchCorridor(net.getId());
             mBg.addRouteWithGridPins(gridRoute);
+            this->addNetSearchStats(gridRoute, iterationSearchStats, netSearchStats);
             totalCurrentRouteCost += gridRoute.currentRouteCost;
 
             // Put back the pin cost on base cost grid
@@ -763,6 +896,7 @@ void GridBasedRouter::route() {
         routingSolutions.push_back(this->mGridNets);
         iterativeCost.push_back(totalCurrentRouteCost);
         std::cout << "i=" << i + 1 << ", totalCurrentRouteCost: " << totalCurrentRouteCost << ", bestTotalRouteCost: " << bestTotalRouteCost << std::endl;
+        this->showSearchStats("i=" + std::to_string(i + 1), iterationSearchStats);
     }
     std::cout << "\n\n======= Rip-up and Re-route cost breakdown =======" << std::endl;
     for (std::size_t i = 0; i < iterativeCost.size(); ++i) {
@@ -790,7 +924,97 @@ void GridBasedRouter::route() {
     nameTag = nameTag + "." + this->getParamsNameTag();
     writeSolutionBackToDbAndSaveOutput(nameTag, this->bestSolution);
 
-    // mBg.showViaCachePerformance();
+    mBg.showMemoryUsage();
+    mBg.showFrontierQoR();
+    mBg.showViaCachePerformance();
+    this->showNetSearchStats(netSearchStats, 10);
+}
+
+void GridBasedRouter::globalRouting() {
+    std::cout << "\n\n======= Global Routing. =======\n\n";
+    const int gcellSize = std::max(this->dbLengthToGridLengthCeil(GlobalParam::gGlobalRoutingGCellSize), 1);
+    mGlobalGrid.initialization(mBg.w, mBg.h, gcellSize);
+    // Pins are on the base cost already
+    mGlobalGrid.setupCapacity(mBg, GlobalParam::gPinObstacleCost);
+
+    for (auto &net : mDb.getNets()) {
+        if (net.getPins().size() < 2)
+            continue;
+        if (!mDb.isNetclassId(net.getNetclassId())) {
+            std::cerr << __FUNCTION__ << "() Invalid netclass id: " << net.getNetclassId() << std::endl;
+            continue;
+        }
+        // Track width taken by the net
+        auto &netclass = mDb.getNetclass(net.getNetclassId());
+        const float demand = this->dbLengthToGridLength(netclass.getTraceWidth() + netclass.getClearance());
+
+        std::vector<Point_2D<int> > pins;
+        for (auto &gridPin : this->mGridNets.at(net.getId()).mGridPins) {
+            if (gridPin.pinWithLayers.empty())
+                continue;
+            pins.push_back(Point_2D<int>(gridPin.pinWithLayers.front().m_x, gridPin.pinWithLayers.front().m_y));
+        }
+        mGlobalGrid.addNet(net.getId(), pins, demand);
+    }
+    mGlobalGrid.route(GlobalParam::gGlobalRoutingIterations);
+    mGlobalGrid.showCongestion();
+
+    if (GlobalParam::gOutputDebuggingGridValuesPyFile) {
+        std::string mapNameTag = util::getFileNameWoExtension(mDb.getFileName()) + ".global" + this->getParamsNameTag();
+        mGlobalGrid.printCongestionMap(mapNameTag);
+    }
+}
+
+void GridBasedRouter::setupSearchCorridor(const int netId) {
+    if (mGlobalGrid.empty() || GlobalParam::gGlobalRoutingGCellSize <= 0.0)
+        return;
+    std::vector<std::uint8_t> corridor;
+    mGlobalGrid.getCorridor(netId, GlobalParam::gGlobalRoutingCorridorMargin, corridor);
+    mBg.setSearchCorridor(corridor, mGlobalGrid.getGCellSize());
+}
+
+void GridBasedRouter::addNetSearchStats(const MultipinRoute &gridRoute, SearchStats &iterationStats, std::vector<SearchStats> &netStats) {
+    const SearchStats &stats = gridRoute.getSearchStats();
+    iterationStats.add(stats);
+    netStats.at(gridRoute.netId).add(stats);
+    if (gridRoute.isSearchCapped()) {
+        std::cout << "!!!!!!! netId: " << gridRoute.netId << ", " << stats.numCappedConnections << " connection(s) not routed, search expansion limit reached" << std::endl;
+    }
+}
+
+void GridBasedRouter::showSearchStats(const std::string &label, const SearchStats &stats) const {
+    std::cout << label << ", searches: #connections: " << stats.numConnections << ", #capped: " << stats.numCappedConnections
+              << ", #pops: " << stats.numPops << ", #pushes: " << stats.numPushes << ", #stale pops: " << stats.numStalePops
+              << ", #neighbors: " << stats.numNeighbors << ", via cache hits/misses: " << stats.numViaCacheHits << "/" << stats.numViaCacheMisses
+              << ", peak frontier: " << stats.peakFrontierSize << ", time: " << stats.seconds << "s" << std::endl;
+}
+
+void GridBasedRouter::showNetSearchStats(const std::vector<SearchStats> &netStats, const std::size_t numNets) const {
+    std::vector<int> netIds;
+    for (std::size_t netId = 0; netId < netStats.size(); ++netId) {
+        if (netStats[netId].numConnections > 0) {
+            netIds.push_back(netId);
+        }
+    }
+    std::sort(netIds.begin(), netIds.end(), [&](const int a, const int b) { return netStats[a].seconds > netStats[b].seconds; });
+    netIds.resize(std::min(netIds.size(), numNets));
+
+    std::cout << "\n\n======= Search time by net, all iterations =======" << std::endl;
+    for (const int netId : netIds) {
+        this->showSearchStats("netId: " + std::to_string(netId) + ", " + mDb.getNet(netId).getName(), netStats[netId]);
+    }
+}
+
+double GridBasedRouter::getHeuristicWeight(const int i) const {
+    // Linearly down to 1 at iteration gHeuristicWeightIterations
+    const int numIterations = GlobalParam::gHeuristicWeightIterations;
+    if (numIterations == 0) {
+        return GlobalParam::gHeuristicWeight;
+    }
+    if (i >= numIterations) {
+        return 1.0;
+    }
+    return GlobalParam::gHeuristicWeight - (GlobalParam::gHeuristicWeight - 1.0) * i / numIterations;
 }
 
 void GridBasedRouter::testRouterWithPinShape() {
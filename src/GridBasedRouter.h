@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "BoardGrid.h"
+#include "GlobalGrid.h"
 #include "globalParam.h"
 #include "kicadPcbDataBase.h"
 #include "util.h"
@@ -31,6 +32,39 @@ class GridBasedRouter {
     }
     void set_num_iterations(const int _numRRI) { GlobalParam::gNumRipUpReRouteIteration = abs(_numRRI); }
     void set_enlarge_boundary(const int _eB) { GlobalParam::enlargeBoundary = abs(_eB); }
+    void set_grid_tile_size(const int _gts) { GlobalParam::gGridTileSize = abs(_gts); }
+    void set_grid_tile_layer_interleave(const bool _gtli) { GlobalParam::gGridTileLayerInterleave = _gtli; }
+    void set_grid_sparse(const bool _gs) { GlobalParam::gGridSparse = _gs; }
+    void set_search_window_margin(const int _swm) { GlobalParam::gSearchWindowMargin = _swm; }
+    void set_grid_mmap_directory(const std::string &_gmd) { GlobalParam::gGridMmapDirectory = _gmd; }
+    void set_grid_huge_pages(const bool _ghp) { GlobalParam::gGridHugePages = _ghp; }
+    void set_grid_numa_interleave(const bool _gni) { GlobalParam::gGridNumaInterleave = _gni; }
+    void set_memory_budget_mb(const double _mb) { GlobalParam::gMemoryBudgetMB = abs(_mb); }
+    void set_time_budget(const double _tb) { GlobalParam::gTimeBudget = abs(_tb); }
+    void set_90_degree_mode(const bool _90dm) { GlobalParam::g90DegreeMode = _90dm; }
+    void set_bending_aware_search(const bool _bas) { GlobalParam::gBendingAwareSearch = _bas; }
+    void set_pin_order(const int _po) { GlobalParam::gPinOrder = _po; }
+    void set_bucket_frontier(const bool _bf) { GlobalParam::gBucketFrontier = _bf; }
+    void set_bucket_frontier_resolution(const double _bfr) {
+        if (_bfr > 0.0) GlobalParam::gBucketFrontierResolution = _bfr;
+    }
+    void set_bucket_frontier_qor_check(const bool _bfqc) { GlobalParam::gBucketFrontierQoRCheck = _bfqc; }
+    void set_bidirectional_search(const bool _bs) { GlobalParam::gBidirectionalSearch = _bs; }
+    void set_target_distance_map_block_size(const int _tdmbs) { GlobalParam::gTargetDistanceMapBlockSize = abs(_tdmbs); }
+    void set_incremental_search(const bool _is) { GlobalParam::gIncrementalSearch = _is; }
+    void set_heuristic_weight(const double _hw) {
+        if (_hw >= 1.0) GlobalParam::gHeuristicWeight = _hw;
+    }
+    void set_heuristic_weight_iterations(const int _hwi) { GlobalParam::gHeuristicWeightIterations = abs(_hwi); }
+    void set_global_routing_gcell_size(const double _gs) { GlobalParam::gGlobalRoutingGCellSize = abs(_gs); }
+    void set_global_routing_corridor_margin(const int _cm) { GlobalParam::gGlobalRoutingCorridorMargin = abs(_cm); }
+    void set_global_routing_iterations(const int _gi) { GlobalParam::gGlobalRoutingIterations = abs(_gi); }
+    void set_jump_search(const bool _js) { GlobalParam::gJumpSearch = _js; }
+    void set_search_expansion_limit(const int _sel) { GlobalParam::gSearchExpansionLimit = abs(_sel); }
+    void set_num_landmarks(const int _nl) { GlobalParam::gNumLandmarks = abs(_nl); }
+    void set_landmark_block_size(const int _lbs) {
+        if (_lbs > 0) GlobalParam::gLandmarkBlockSize = _lbs;
+    }
 
     void set_wirelength_weight(const double _ww) { GlobalParam::gWirelengthCost = abs(_ww); }
     void set_diagonal_wirelength_weight(const double _dww) { GlobalParam::gDiagonalCost = abs(_dww); }
@@ -50,6 +84,33 @@ class GridBasedRouter {
     unsigned int get_grid_scale() { return GlobalParam::inputScale; }
     unsigned int get_num_iterations() { return GlobalParam::gNumRipUpReRouteIteration; }
     unsigned int get_enlarge_boundary() { return GlobalParam::enlargeBoundary; }
+    unsigned int get_grid_tile_size() { return GlobalParam::gGridTileSize; }
+    bool get_grid_tile_layer_interleave() { return GlobalParam::gGridTileLayerInterleave; }
+    bool get_grid_sparse() { return GlobalParam::gGridSparse; }
+    int get_search_window_margin() { return GlobalParam::gSearchWindowMargin; }
+    std::string get_grid_mmap_directory() { return GlobalParam::gGridMmapDirectory; }
+    bool get_grid_huge_pages() { return GlobalParam::gGridHugePages; }
+    bool get_grid_numa_interleave() { return GlobalParam::gGridNumaInterleave; }
+    double get_memory_budget_mb() { return GlobalParam::gMemoryBudgetMB; }
+    double get_time_budget() { return GlobalParam::gTimeBudget; }
+    bool get_90_degree_mode() { return GlobalParam::g90DegreeMode; }
+    bool get_bending_aware_search() { return GlobalParam::gBendingAwareSearch; }
+    int get_pin_order() { return GlobalParam::gPinOrder; }
+    bool get_bucket_frontier() { return GlobalParam::gBucketFrontier; }
+    double get_bucket_frontier_resolution() { return GlobalParam::gBucketFrontierResolution; }
+    bool get_bucket_frontier_qor_check() { return GlobalParam::gBucketFrontierQoRCheck; }
+    bool get_bidirectional_search() { return GlobalParam::gBidirectionalSearch; }
+    unsigned int get_target_distance_map_block_size() { return GlobalParam::gTargetDistanceMapBlockSize; }
+    bool get_incremental_search() { return GlobalParam::gIncrementalSearch; }
+    double get_heuristic_weight() { return GlobalParam::gHeuristicWeight; }
+    unsigned int get_heuristic_weight_iterations() { return GlobalParam::gHeuristicWeightIterations; }
+    double get_global_routing_gcell_size() { return GlobalParam::gGlobalRoutingGCellSize; }
+    unsigned int get_global_routing_corridor_margin() { return GlobalParam::gGlobalRoutingCorridorMargin; }
+    unsigned int get_global_routing_iterations() { return GlobalParam::gGlobalRoutingIterations; }
+    bool get_jump_search() { return GlobalParam::gJumpSearch; }
+    unsigned int get_search_expansion_limit() { return GlobalParam::gSearchExpansionLimit; }
+    unsigned int get_num_landmarks() { return GlobalParam::gNumLandmarks; }
+    unsigned int get_landmark_block_size() { return GlobalParam::gLandmarkBlockSize; }
 
     double get_wirelength_weight() { return GlobalParam::gWirelengthCost; }
     double get_diagonal_wirelength_weight() { return GlobalParam::gDiagonalCost; }
@@ -77,6 +138,7 @@ class GridBasedRouter {
 
     // Helpers
     void setupBoardGrid();
+    void selectGridScale();
     void setupLayerMapping();
     void setupGridNetclass();
     void setupGridNetsAndGridPins();
@@ -98,6 +160,17 @@ class GridBasedRouter {
     bool getGridLayers(const padstack &, const instance &, std::vector<int> &layers);
 
     int getNextRipUpNetId();
+    // Weight of the A* estimates in routing pass i, 0 being the first one before rip-up and re-route
+    double getHeuristicWeight(const int i) const;
+    // Routes all nets over the GCells of mGlobalGrid (GlobalParam::gGlobalRoutingGCellSize)
+    void globalRouting();
+    // Bounds the detailed searches of the net to the corridor of its global route
+    void setupSearchCorridor(const int netId);
+    // Adds the search statistics of the net just routed to the iteration's and the net's, flags capped searches
+    void addNetSearchStats(const MultipinRoute &gridRoute, SearchStats &iterationStats, std::vector<SearchStats> &netStats);
+    void showSearchStats(const std::string &label, const SearchStats &stats) const;
+    // The nets taking the most search time
+    void showNetSearchStats(const std::vector<SearchStats> &netStats, const std::size_t numNets) const;
     std::string getParamsNameTag();
 
     // Utilities
@@ -122,6 +195,7 @@ class GridBasedRouter {
 
    private:
     BoardGrid mBg;
+    GlobalGrid mGlobalGrid;
     kicadPcbDataBase &mDb;
 
     // Layer mapping between DB and BoardGrid
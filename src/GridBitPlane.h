@@ -0,0 +1,62 @@
+#ifndef PCBROUTER_GRID_BIT_PLANE_H
+#define PCBROUTER_GRID_BIT_PLANE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// One bit per grid cell, packed 64 cells of a row per word so that x ranges can be tested a word at a time
+class GridBitPlane {
+   public:
+    //ctor
+    GridBitPlane() {}
+    //dtor
+    ~GridBitPlane() {}
+
+    void allocate(const int w, const int h, const int l) {
+        this->mH = h;
+        this->mWordsPerRow = (w + 63) >> 6;
+        this->mWords.assign((std::size_t)this->mWordsPerRow * h * l, 0);
+    }
+    void reset() { std::fill(this->mWords.begin(), this->mWords.end(), 0); }
+    std::size_t allocatedBytes() const { return sizeof(std::uint64_t) * this->mWords.size(); }
+
+    inline void set(const int x, const int y, const int z) { this->mWords[this->wordId(x, y, z)] |= bit(x); }
+    inline void clear(const int x, const int y, const int z) { this->mWords[this->wordId(x, y, z)] &= ~bit(x); }
+    inline bool test(const int x, const int y, const int z) const { return this->mWords[this->wordId(x, y, z)] & bit(x); }
+
+    // Any bit set in [x0, x1] x [y0, y1] x [z0, z1], the box must be inside the grid
+    bool any(const int x0, const int x1, const int y0, const int y1, const int z0, const int z1) const {
+        const int firstWord = x0 >> 6, lastWord = x1 >> 6;
+        const std::uint64_t firstMask = ~std::uint64_t(0) << (x0 & 63);
+        const std::uint64_t lastMask = ~std::uint64_t(0) >> (63 - (x1 & 63));
+        for (int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                const std::uint64_t *row = &this->mWords[this->wordId(0, y, z)];
+                if (firstWord == lastWord) {
+                    if (row[firstWord] & firstMask & lastMask) return true;
+                    continue;
+                }
+                if (row[firstWord] & firstMask) return true;
+                for (int word = firstWord + 1; word < lastWord; ++word) {
+                    if (row[word]) return true;
+                }
+                if (row[lastWord] & lastMask) return true;
+            }
+        }
+        return false;
+    }
+
+   private:
+    inline std::size_t wordId(const int x, const int y, const int z) const {
+        return ((std::size_t)z * this->mH + y) * this->mWordsPerRow + (x >> 6);
+    }
+    static inline std::uint64_t bit(const int x) { return std::uint64_t(1) << (x & 63); }
+
+    int mH = 0;
+    int mWordsPerRow = 0;
+    std::vector<std::uint64_t> mWords;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef PCBROUTER_GRID_PLANE_H
+#define PCBROUTER_GRID_PLANE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "GridAllocator.h"
+
+// A contiguous array holding one per-cell field of the BoardGrid (structure-of-arrays storage)
+// In sparse mode the ids are split into chunks of (1 << chunkShift) cells, which are allocated on
+// the first non-const access. Reads of unallocated chunks return the plane's default value.
+// Dense planes get their memory from GridAllocator, sparse chunks come from the heap.
+template <typename T>
+class GridPlane {
+    static_assert(std::is_trivially_copyable<T>::value, "GridPlane storage is raw memory");
+
+   public:
+    //ctor
+    GridPlane() {}
+    //dtor
+    ~GridPlane() { this->release(); }
+
+    GridPlane(const GridPlane &) = delete;
+    GridPlane &operator=(const GridPlane &) = delete;
+
+    void allocate(const int size, const T &value) {
+        assert(this->mData == nullptr && this->mChunks.empty());
+        this->mAllocation = GridAllocator::allocate(sizeof(T) * size);
+        this->mData = static_cast<T *>(this->mAllocation.ptr);
+        this->mSize = size;
+        this->fill(value);
+    }
+    void allocateSparse(const int size, const int chunkShift, const T &value) {
+        assert(this->mData == nullptr && this->mChunks.empty());
+        this->mSize = size;
+        this->mChunkShift = chunkShift;
+        this->mChunkMask = (1 << chunkShift) - 1;
+        this->mChunks.assign(((size - 1) >> chunkShift) + 1, nullptr);
+        this->mDefault = value;
+    }
+    void release() {
+        if (this->mData) {
+            GridAllocator::release(this->mAllocation);
+        }
+        this->mData = nullptr;
+        this->releaseChunks();
+        this->mChunks.clear();
+        this->mSize = 0;
+    }
+    // Sparse planes drop all chunks, so fill() also returns their memory
+    void fill(const T &value) {
+        if (this->mData) {
+            std::fill(this->mData, this->mData + this->mSize, value);
+        } else {
+            this->releaseChunks();
+            this->mDefault = value;
+        }
+    }
+
+    int size() const { return mSize; }
+    bool empty() const { return mData == nullptr && mChunks.empty(); }
+    bool sparse() const { return !mChunks.empty(); }
+    bool fileBacked() const { return mAllocation.backing == GridBacking::FILE; }
+    // Prefetch hint for the ids [beginId, endId) of a file-backed plane
+    void adviseWillNeed(const int beginId, const int endId) const {
+        if (this->fileBacked()) {
+            GridAllocator::adviseWillNeed(this->mAllocation, sizeof(T) * beginId, sizeof(T) * (endId - beginId));
+        }
+    }
+    std::size_t allocatedBytes() const {
+        if (this->mData) return sizeof(T) * this->mSize;
+        return sizeof(T) * this->mNumAllocatedChunks * (this->mChunkMask + 1) + sizeof(T *) * this->mChunks.size();
+    }
+    T *data() {
+        assert(!this->sparse());
+        return mData;
+    }
+    const T *data() const {
+        assert(!this->sparse());
+        return mData;
+    }
+
+    // Read without allocating, also from non-const contexts
+    inline const T &get(const int id) const {
+        if (this->mData) return this->mData[id];
+        const T *chunk = this->mChunks[id >> this->mChunkShift];
+        return chunk ? chunk[id & this->mChunkMask] : this->mDefault;
+    }
+    inline const T &operator[](const int id) const { return this->get(id); }
+    inline T &operator[](const int id) {
+        if (this->mData) return this->mData[id];
+        T *&chunk = this->mChunks[id >> this->mChunkShift];
+        if (!chunk) chunk = this->allocateChunk();
+        return chunk[id & this->mChunkMask];
+    }
+
+   private:
+    T *allocateChunk() {
+        T *chunk = new T[this->mChunkMask + 1];
+        std::fill(chunk, chunk + this->mChunkMask + 1, this->mDefault);
+        ++this->mNumAllocatedChunks;
+        return chunk;
+    }
+    void releaseChunks() {
+        for (auto &chunk : this->mChunks) {
+            delete[] chunk;
+            chunk = nullptr;
+        }
+        this->mNumAllocatedChunks = 0;
+    }
+
+    T *mData = nullptr;
+    int mSize = 0;
+    GridAllocation mAllocation;
+
+    // Sparse storage
+    std::vector<T *> mChunks;
+    int mChunkShift = 0;
+    int mChunkMask = 0;
+    int mNumAllocatedChunks = 0;
+    T mDefault = T();
+};
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef PCBROUTER_LANDMARK_TABLES_H
+#define PCBROUTER_LANDMARK_TABLES_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "GridAllocator.h"
+#include "point.h"
+
+// ALT (A*, landmarks, triangle inequality) lower bounds of the cost still to pay to reach the
+// targeted pin, apart from the wirelength, over blocks of 2^shift x 2^shift cells per layer. A move
+// between two blocks costs the lower of their minimum base costs, a via the layer change cost, so
+// the block distances are symmetric and never above the cost of a path. With the distances d(L, .)
+// from a landmark block L, d(v, t) >= |d(L, t) - d(L, v)|. The tables are built once for many
+// searches; base costs dropping below their block's minimum afterwards lower the bounds by as much
+// while they last, so the bounds stay admissible until the next build.
+class LandmarkTables {
+   public:
+    //ctor
+    LandmarkTables() {}
+    //dtor
+    ~LandmarkTables() {}
+
+    LandmarkTables(const LandmarkTables &) = delete;
+    LandmarkTables &operator=(const LandmarkTables &) = delete;
+
+    // For a w x h x l grid, the base costs are reset to be lowered by lowerBaseCost() before build()
+    void setup(const int w, const int h, const int l, const int shift) {
+        assert(w > 0 && h > 0 && l > 0 && shift >= 0);
+        this->mShift = shift;
+        this->mW = ((w - 1) >> shift) + 1;
+        this->mH = ((h - 1) >> shift) + 1;
+        this->mL = l;
+        const int numBlocks = this->mW * this->mH * this->mL;
+        this->mBaseCost.assign(numBlocks, std::numeric_limits<float>::infinity());
+        this->mNumCellsBelow.assign(numBlocks, 0);
+        this->mBlockCostDrop.assign(numBlocks, 0.0);
+        this->mLandmarks.clear();
+        this->mDistance.clear();
+        this->mCostDrop = 0.0;
+    }
+    void clear() {
+        this->mLandmarks.clear();
+        this->mDistance.clear();
+    }
+
+    // No tables built
+    bool empty() const { return mLandmarks.empty(); }
+    int numLandmarks() const { return mLandmarks.size(); }
+    int numBlocks() const { return mBaseCost.size(); }
+    double costDrop() const { return mCostDrop; }
+    std::size_t allocatedBytes() const {
+        return (this->mBaseCost.capacity() + this->mBlockCostDrop.capacity() + this->mDistance.capacity()) * sizeof(float) +
+               this->mNumCellsBelow.capacity() * sizeof(int);
+    }
+
+    inline int blockId(const Location &l) const { return (l.m_z * this->mH + (l.m_y >> this->mShift)) * this->mW + (l.m_x >> this->mShift); }
+    // Lowers the base cost of the block of l to the one of l, 0 at least
+    inline void lowerBaseCost(const Location &l, const float value) {
+        float &cost = this->mBaseCost[this->blockId(l)];
+        cost = std::min(cost, std::max(value, 0.0f));
+    }
+    // After build(), the base cost of l changed from oldValue to value. A block's drop below its
+    // minimum counts until none of its cells is below it anymore.
+    inline void updateBaseCost(const Location &l, const float oldValue, const float value) {
+        const int id = this->blockId(l);
+        const float minCost = this->mBaseCost[id];
+        const bool wasBelow = oldValue < minCost;
+        const bool isBelow = value < minCost;
+        if (!wasBelow && !isBelow) return;
+        this->mNumCellsBelow[id] += (int)isBelow - (int)wasBelow;
+        if (this->mNumCellsBelow[id] == 0) {
+            this->mCostDrop -= this->mBlockCostDrop[id];
+            this->mBlockCostDrop[id] = 0.0;
+        } else if (isBelow && minCost - std::max(value, 0.0f) > this->mBlockCostDrop[id]) {
+            const float drop = minCost - std::max(value, 0.0f);
+            this->mCostDrop += drop - this->mBlockCostDrop[id];
+            this->mBlockCostDrop[id] = drop;
+        }
+    }
+
+    // Distance tables of numLandmarks blocks, 8-connected on a layer. Vias connect adjacent layers
+    // only for micro vias. Each landmark is the block farthest from the ones before (the first one,
+    // from the center of the board), farther in blocks between equally costly ones, so they spread
+    // over the board and its obstacles.
+    void build(const int numLandmarks, const double layerChangeCost, const bool microVia) {
+        assert(numLandmarks > 0);
+        const int numBlocks = this->mBaseCost.size();
+        this->mLandmarks.clear();
+        this->mDistance.assign((std::size_t)numLandmarks * numBlocks, 0.0);
+        this->mTargetMin.assign(numLandmarks, 0.0);
+        this->mTargetMax.assign(numLandmarks, 0.0);
+        this->mCostDrop = 0.0;
+        std::fill(this->mNumCellsBelow.begin(), this->mNumCellsBelow.end(), 0);
+        std::fill(this->mBlockCostDrop.begin(), this->mBlockCostDrop.end(), 0.0);
+
+        std::vector<float> nearestCost(numBlocks, std::numeric_limits<float>::infinity());
+        std::vector<int> nearestSpan(numBlocks, std::numeric_limits<int>::max());
+        std::vector<float> centerDistance(numBlocks);
+        const int center = (this->mH / 2) * this->mW + this->mW / 2;
+        this->distancesFrom(center, layerChangeCost, microVia, centerDistance.data());
+        const float *previous = centerDistance.data();
+        int previousId = center;
+        for (int i = 0; i < numLandmarks; ++i) {
+            int landmark = -1;
+            for (int id = 0; id < numBlocks; ++id) {
+                nearestCost[id] = std::min(nearestCost[id], previous[id]);
+                nearestSpan[id] = std::min(nearestSpan[id], this->span(id, previousId));
+                if (landmark < 0 || nearestCost[id] > nearestCost[landmark] ||
+                    (nearestCost[id] == nearestCost[landmark] && nearestSpan[id] > nearestSpan[landmark])) {
+                    landmark = id;
+                }
+            }
+            // Every block is a landmark already
+            if (nearestCost[landmark] == 0.0 && nearestSpan[landmark] == 0) break;
+
+            float *distance = &this->mDistance[(std::size_t)i * numBlocks];
+            this->distancesFrom(landmark, layerChangeCost, microVia, distance);
+            this->mLandmarks.push_back(landmark);
+            previous = distance;
+            previousId = landmark;
+        }
+        this->mDistance.resize(this->mLandmarks.size() * numBlocks);
+    }
+
+    // Bounds towards the closest of the targets
+    void setTargets(const std::vector<Location> &targets) {
+        assert(!targets.empty());
+        const int numBlocks = this->mBaseCost.size();
+        for (int i = 0; i < this->numLandmarks(); ++i) {
+            const float *distance = &this->mDistance[(std::size_t)i * numBlocks];
+            this->mTargetMin[i] = std::numeric_limits<float>::infinity();
+            this->mTargetMax[i] = 0.0;
+            for (const auto &target : targets) {
+                this->mTargetMin[i] = std::min(this->mTargetMin[i], distance[this->blockId(target)]);
+                this->mTargetMax[i] = std::max(this->mTargetMax[i], distance[this->blockId(target)]);
+            }
+        }
+    }
+
+    inline float at(const Location &l) const {
+        const int id = this->blockId(l);
+        const std::size_t numBlocks = this->mBaseCost.size();
+        float bound = 0.0;
+        for (std::size_t i = 0; i < this->mLandmarks.size(); ++i) {
+            const float distance = this->mDistance[i * numBlocks + id];
+            bound = std::max(bound, std::max(this->mTargetMin[i] - distance, distance - this->mTargetMax[i]));
+        }
+        return std::max(bound - (float)this->mCostDrop, 0.0f);
+    }
+
+   private:
+    // Shortest paths from block source
+    void distancesFrom(const int source, const double layerChangeCost, const bool microVia, float *distance) const {
+        typedef std::pair<float, int> Item;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+        std::fill(distance, distance + this->mBaseCost.size(), std::numeric_limits<float>::infinity());
+        distance[source] = 0.0;
+        queue.push(Item(0.0, source));
+
+        auto relax = [&](const int next, const float cost) {
+            if (cost < distance[next]) {
+                distance[next] = cost;
+                queue.push(Item(cost, next));
+            }
+        };
+        const int layerStride = this->mW * this->mH;
+        while (!queue.empty()) {
+            const Item item = queue.top();
+            queue.pop();
+            const int id = item.second;
+            if (item.first > distance[id]) continue;
+
+            const int x = id % this->mW;
+            const int y = id / this->mW % this->mH;
+            const int z = id / layerStride;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if ((dx == 0 && dy == 0) || x + dx < 0 || x + dx >= this->mW || y + dy < 0 || y + dy >= this->mH) continue;
+                    const int next = id + dy * this->mW + dx;
+                    relax(next, item.first + std::min(this->mBaseCost[id], this->mBaseCost[next]));
+                }
+            }
+            for (int nz = 0; nz < this->mL; ++nz) {
+                if (nz == z || (microVia && abs(nz - z) != 1)) continue;
+                relax(id + (nz - z) * layerStride, item.first + (float)layerChangeCost);
+            }
+        }
+    }
+    // Chebyshev distance between blocks a and b, the layers counted as a third axis
+    inline int span(const int a, const int b) const {
+        const int layerStride = this->mW * this->mH;
+        return std::max(std::max(abs(a % this->mW - b % this->mW), abs(a / this->mW % this->mH - b / this->mW % this->mH)), abs(a / layerStride - b / layerStride));
+    }
+
+    int mShift = 0;
+    int mW = 0;
+    int mH = 0;
+    int mL = 0;
+
+    std::vector<float, GridStdAllocator<float>> mBaseCost;       // Per block, minimum base cost of its cells when built
+    std::vector<int, GridStdAllocator<int>> mNumCellsBelow;      // Per block, cells below its mBaseCost since built
+    std::vector<float, GridStdAllocator<float>> mBlockCostDrop;  // Per block, largest drop of those cells
+    double mCostDrop = 0.0;                                      // Sum of mBlockCostDrop
+
+    std::vector<int> mLandmarks;                            // Block ids
+    std::vector<float, GridStdAllocator<float>> mDistance;  // Per landmark, per block
+    std::vector<float> mTargetMin;                          // Per landmark, distance of the closest target
+    std::vector<float> mTargetMax;                          // Per landmark, distance of the farthest target
+};
+
+#endif
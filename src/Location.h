@@ -2,41 +2,9 @@
 #define PCBROUTER_LOCATION_H
 
 #include <algorithm>
-#include <queue>
 #include <unordered_set>
 #include <vector>
 
-// custom Location priority queue class for search
-template <typename T, typename priority_t>
-struct LocationQueue {
-    typedef std::pair<priority_t, T> PQElement;
-    std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> elements;
-
-    inline bool empty() const {
-        return elements.empty();
-    }
-
-    inline void push(T item, priority_t priority) {
-        elements.emplace(priority, item);
-    }
-
-    inline size_t size() const {
-        return elements.size();
-    }
-
-    T front() {
-        return elements.top().second;  // best item
-    }
-
-    priority_t frontKey() {
-        return elements.top().first;  // best item's key values
-    }
-
-    inline void pop() {
-        elements.pop();
-    }
-};
-
 // Hash function for Location to support unordered_set
 namespace std {
 template <>
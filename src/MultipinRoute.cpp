@@ -24,6 +24,55 @@ int MultipinRoute::getRoutedNumBends() const {
     return numRoutedBends;
 }
 
+void MultipinRoute::orderGridPins(const int pinOrder) {
+    if ((pinOrder != PIN_ORDER_MST && pinOrder != PIN_ORDER_STEINER) || this->mGridPins.size() <= 2) {
+        return;
+    }
+
+    // Prim's algorithm from the first pin, O(n^2) on the xy of the pins
+    const int numPins = this->mGridPins.size();
+    auto pinXY = [&](const int i) { return this->mGridPins[i].pinWithLayers.front(); };
+    std::vector<int> order{0};
+    std::vector<int> distance(numPins, std::numeric_limits<int>::max());  // To the tree so far
+    std::vector<int> parent(numPins, 0);
+    std::vector<bool> connected(numPins, false);
+    connected[0] = true;
+    int last = 0;
+    while ((int)order.size() < numPins) {
+        const Location &lastPt = pinXY(last);
+        const Location &parentPt = pinXY(parent[last]);
+        int next = -1;
+        for (int i = 0; i < numPins; ++i) {
+            if (connected[i]) continue;
+            const Location &pt = pinXY(i);
+            int d = abs(pt.m_x - lastPt.m_x) + abs(pt.m_y - lastPt.m_y);
+            if (pinOrder == PIN_ORDER_STEINER && last != 0) {
+                // The connection of last to its parent runs (most likely) inside their bounding box
+                const int dx = std::max(0, std::max(std::min(lastPt.m_x, parentPt.m_x) - pt.m_x, pt.m_x - std::max(lastPt.m_x, parentPt.m_x)));
+                const int dy = std::max(0, std::max(std::min(lastPt.m_y, parentPt.m_y) - pt.m_y, pt.m_y - std::max(lastPt.m_y, parentPt.m_y)));
+                d = std::min(d, dx + dy);
+            }
+            if (d < distance[i]) {
+                distance[i] = d;
+                parent[i] = last;
+            }
+            if (next < 0 || distance[i] < distance[next]) {
+                next = i;
+            }
+        }
+        connected[next] = true;
+        order.push_back(next);
+        last = next;
+    }
+
+    std::vector<GridPin> orderedPins;
+    orderedPins.reserve(numPins);
+    for (const int i : order) {
+        orderedPins.push_back(this->mGridPins[i]);
+    }
+    this->mGridPins.swap(orderedPins);
+}
+
 void MultipinRoute::gridPathLocationsToSegments() {
     // 1. Copy GridPath's Locations into Segments
     for (auto &&gp : this->mGridPaths) {
@@ -1,13 +1,23 @@
 #ifndef PCBROUTER_MULTI_PIN_ROUTE_H
 #define PCBROUTER_MULTI_PIN_ROUTE_H
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "GridPath.h"
 #include "GridPin.h"
+#include "SearchStats.h"
 #include "globalParam.h"
 #include "point.h"
 
+// Order of the connections of a net (GlobalParam::gPinOrder), each pin connects to the tree of the previous ones
+enum PinOrder {
+    PIN_ORDER_INDEX = 0,   // DB order
+    PIN_ORDER_MST = 1,     // Prim order of a rectilinear MST from the first pin, the pin nearest to the connected ones next
+    PIN_ORDER_STEINER = 2  // As PIN_ORDER_MST, with the distance to the connections so far (bounding boxes of the MST edges)
+};
+
 class MultipinRoute {
    public:
     MultipinRoute() {
@@ -27,6 +37,8 @@ class MultipinRoute {
 
     void featuresToGridPaths();
     void gridPathLocationsToSegments();
+    // Reorders mGridPins, the first pin stays first
+    void orderGridPins(const int pinOrder);
 
     int getGridNetclassId() const { return gridNetclassId; }
 
@@ -43,6 +55,10 @@ class MultipinRoute {
         return mGridPins.back();
     }
 
+    // Of the searches of the last routing of the net
+    const SearchStats &getSearchStats() const { return mSearchStats; }
+    bool isSearchCapped() const { return mSearchStats.numCappedConnections > 0; }
+
     double getRoutedWirelength() const;
     int getRoutedNumVias() const;
     int getRoutedNumBends() const;
@@ -78,6 +94,8 @@ class MultipinRoute {
     // Cost along with this net
     double curTrackObstacleCost = 0.0;
     double curViaObstacleCost = 0.0;
+
+    SearchStats mSearchStats;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef PCBROUTER_SEARCH_MODE_H
+#define PCBROUTER_SEARCH_MODE_H
+
+// Routing mode of an A* search kernel. The kernels are instantiated per mode, so the inner loop
+// carries no run time branch on it.
+template <bool MicroVia, bool Diagonal, bool BendingAware>
+struct SearchMode {
+    static const bool kMicroVia = MicroVia;          // Micro/blind/buried vias between adjacent layers, otherwise through-hole vias
+    static const bool kDiagonal = Diagonal;          // 45-degree steps, otherwise 90-degree (Manhattan) routing
+    static const bool kBendingAware = BendingAware;  // Bends are counted in the cost and the estimate
+};
+
+// Calls kernel(Mode()) with the SearchMode of the given flags, once per search
+template <typename Kernel>
+bool dispatchSearchMode(const bool microVia, const bool diagonal, const bool bendingAware, Kernel &&kernel) {
+    if (microVia) {
+        if (diagonal) {
+            return bendingAware ? kernel(SearchMode<true, true, true>()) : kernel(SearchMode<true, true, false>());
+        }
+        return bendingAware ? kernel(SearchMode<true, false, true>()) : kernel(SearchMode<true, false, false>());
+    }
+    if (diagonal) {
+        return bendingAware ? kernel(SearchMode<false, true, true>()) : kernel(SearchMode<false, true, false>());
+    }
+    return bendingAware ? kernel(SearchMode<false, false, true>()) : kernel(SearchMode<false, false, false>());
+}
+
+#endif
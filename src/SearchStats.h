@@ -0,0 +1,40 @@
+#ifndef PCBROUTER_SEARCH_STATS_H
+#define PCBROUTER_SEARCH_STATS_H
+
+#include <algorithm>
+#include <cstddef>
+
+// Counters of the A* searches of a connection, summed per net and per rip-up and re-route iteration
+class SearchStats {
+   public:
+    //ctor
+    SearchStats() {}
+    //dtor
+    ~SearchStats() {}
+
+    void add(const SearchStats &other) {
+        this->numConnections += other.numConnections;
+        this->numCappedConnections += other.numCappedConnections;
+        this->numPops += other.numPops;
+        this->numPushes += other.numPushes;
+        this->numStalePops += other.numStalePops;
+        this->numNeighbors += other.numNeighbors;
+        this->numViaCacheHits += other.numViaCacheHits;
+        this->numViaCacheMisses += other.numViaCacheMisses;
+        this->peakFrontierSize = std::max(this->peakFrontierSize, other.peakFrontierSize);
+        this->seconds += other.seconds;
+    }
+
+    long long numConnections = 0;
+    long long numCappedConnections = 0;  // Aborted at GlobalParam::gSearchExpansionLimit, no path
+    long long numPops = 0;               // Cells expanded
+    long long numPushes = 0;             // Cells queued, or requeued with a new key
+    long long numStalePops = 0;          // Outdated frontier entries dropped, bucket queues only
+    long long numNeighbors = 0;          // Moves evaluated
+    long long numViaCacheHits = 0;
+    long long numViaCacheMisses = 0;
+    std::size_t peakFrontierSize = 0;
+    double seconds = 0.0;  // Wall time
+};
+
+#endif
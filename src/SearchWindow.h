@@ -0,0 +1,169 @@
+#ifndef PCBROUTER_SEARCH_WINDOW_H
+#define PCBROUTER_SEARCH_WINDOW_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "GridAllocator.h"
+#include "globalParam.h"
+#include "point.h"
+
+// How the search entered a cell, relative to the cell itself
+enum CameFromCode : std::uint8_t {
+    CAME_FROM_NONE = 0,     // Not reached
+    CAME_FROM_SOURCE = 1,   // Start of the search
+    CAME_FROM_PLANAR = 2,   // 2..9: planar step, see cameFromPlanarCode()
+    CAME_FROM_LAYER = 32    // 32 + z: layer change from layer z at the same xy
+};
+// Set in the stored came from code of the cells popped off the frontier
+constexpr std::uint8_t CAME_FROM_EXPANDED_FLAG = 0x80;
+
+// Scratch state of one A* search (working cost, bending cost, came from code) for an xy window of
+// the board on all layers. The buffers only grow, so the following searches reuse them, and the
+// epoch stamps make re-arming the window O(1) regardless of its size.
+class SearchWindow {
+   public:
+    //ctor
+    SearchWindow() {}
+    //dtor
+    ~SearchWindow() {}
+
+    SearchWindow(const SearchWindow &) = delete;
+    SearchWindow &operator=(const SearchWindow &) = delete;
+
+    // Bounds are inclusive
+    void setup(const int minX, const int maxX, const int minY, const int maxY, const int numLayers) {
+        assert(minX <= maxX && minY <= maxY && numLayers > 0);
+        this->mMinX = minX;
+        this->mMaxX = maxX;
+        this->mMinY = minY;
+        this->mMaxY = maxY;
+        this->mW = maxX - minX + 1;
+        this->mH = maxY - minY + 1;
+        this->mNumCells = this->mW * this->mH * numLayers;
+        if ((std::size_t)this->mNumCells > this->mStamps.size()) {
+            this->mWorkingCost.resize(this->mNumCells);
+            this->mBendingCost.resize(this->mNumCells);
+            this->mCameFrom.resize(this->mNumCells);
+            this->mStamps.resize(this->mNumCells, 0);
+        }
+        ++this->mEpoch;
+        if (this->mEpoch == 0) {
+            // Wrapped around, old stamps may match again
+            std::fill(this->mStamps.begin(), this->mStamps.end(), 0);
+            this->mEpoch = 1;
+        }
+    }
+
+    int minX() const { return mMinX; }
+    int maxX() const { return mMaxX; }
+    int minY() const { return mMinY; }
+    int maxY() const { return mMaxY; }
+    int numCells() const { return mNumCells; }
+    std::size_t allocatedBytes() const {
+        return this->mStamps.size() * (2 * sizeof(pr::prCost) + sizeof(std::uint8_t) + sizeof(std::uint16_t));
+    }
+
+    inline bool contains(const Location &l) const {
+        return l.m_x >= this->mMinX && l.m_x <= this->mMaxX && l.m_y >= this->mMinY && l.m_y <= this->mMaxY;
+    }
+    inline int id(const Location &l) const {
+        return (l.m_z * this->mH + l.m_y - this->mMinY) * this->mW + l.m_x - this->mMinX;
+    }
+    inline void idToLocation(const int id, Location &l) const {
+        const int row = id / this->mW;
+        l.m_x = id - row * this->mW + this->mMinX;
+        l.m_y = row % this->mH + this->mMinY;
+        l.m_z = row / this->mH;
+    }
+
+    // Cells not written since setup() read as unvisited
+    inline pr::prCost workingCost(const int id) const {
+        return this->mStamps[id] == this->mEpoch ? this->mWorkingCost[id] : pr::kCostInfinity;
+    }
+    inline pr::prCost bendingCost(const int id) const { return this->mStamps[id] == this->mEpoch ? this->mBendingCost[id] : 0; }
+    inline std::uint8_t cameFrom(const int id) const {
+        return this->mStamps[id] == this->mEpoch ? this->mCameFrom[id] & ~CAME_FROM_EXPANDED_FLAG : CAME_FROM_NONE;
+    }
+    // Popped off the frontier since its came from code was last set
+    inline bool isExpanded(const int id) const { return this->mStamps[id] == this->mEpoch && (this->mCameFrom[id] & CAME_FROM_EXPANDED_FLAG); }
+    inline void setExpanded(const int id) {
+        this->touch(id);
+        this->mCameFrom[id] |= CAME_FROM_EXPANDED_FLAG;
+    }
+
+    inline void setWorkingCost(const int id, const pr::prCost value) {
+        this->touch(id);
+        this->mWorkingCost[id] = value;
+    }
+    inline void setBendingCost(const int id, const pr::prCost value) {
+        this->touch(id);
+        this->mBendingCost[id] = value;
+    }
+    // Clears the expanded flag, the cell is reached by another path
+    inline void setCameFrom(const int id, const std::uint8_t code) {
+#ifdef BOUND_CHECKS
+        assert(!(code & CAME_FROM_EXPANDED_FLAG));
+#endif
+        this->touch(id);
+        this->mCameFrom[id] = code;
+    }
+
+    // Came from codes
+    static inline std::uint8_t cameFromPlanarCode(const int dx, const int dy) {
+        // (dx, dy) of the step into the cell, both in [-1, 1] and not both 0
+        const int index = (dx + 1) * 3 + dy + 1;
+        return CAME_FROM_PLANAR + index - (index > 4);
+    }
+    static inline std::uint8_t cameFromCode(const Location &l, const Location &prev) {
+        if (l.m_z != prev.m_z) return CAME_FROM_LAYER + prev.m_z;
+        if (l.m_x == prev.m_x && l.m_y == prev.m_y) return CAME_FROM_SOURCE;
+        return cameFromPlanarCode(l.m_x - prev.m_x, l.m_y - prev.m_y);
+    }
+    // A source (or an unreached cell) is its own previous location
+    static inline void cameFromLocation(const Location &l, const std::uint8_t code, Location &prev) {
+        static const int kDx[] = {0, 0, -1, -1, -1, 0, 0, 1, 1, 1};
+        static const int kDy[] = {0, 0, -1, 0, 1, -1, 1, -1, 0, 1};
+        prev = l;
+        if (code >= CAME_FROM_LAYER) {
+            prev.m_z = code - CAME_FROM_LAYER;
+        } else {
+            prev.m_x -= kDx[code];
+            prev.m_y -= kDy[code];
+        }
+    }
+    // Going on from l to next keeps the planar direction l was entered with
+    static inline bool isStraight(const std::uint8_t code, const Location &l, const Location &next) {
+        return code >= CAME_FROM_PLANAR && code < CAME_FROM_LAYER && next.m_z == l.m_z &&
+               code == cameFromPlanarCode(next.m_x - l.m_x, next.m_y - l.m_y);
+    }
+
+   private:
+    inline void touch(const int id) {
+        if (this->mStamps[id] != this->mEpoch) {
+            this->mStamps[id] = this->mEpoch;
+            this->mWorkingCost[id] = pr::kCostInfinity;
+            this->mBendingCost[id] = 0;
+            this->mCameFrom[id] = CAME_FROM_NONE;
+        }
+    }
+
+    int mMinX = 0;
+    int mMaxX = -1;
+    int mMinY = 0;
+    int mMaxY = -1;
+    int mW = 0;
+    int mH = 0;
+    int mNumCells = 0;
+
+    std::vector<pr::prCost, GridStdAllocator<pr::prCost>> mWorkingCost;
+    std::vector<pr::prCost, GridStdAllocator<pr::prCost>> mBendingCost;
+    std::vector<std::uint8_t, GridStdAllocator<std::uint8_t>> mCameFrom;  // CameFromCode
+    std::vector<std::uint16_t, GridStdAllocator<std::uint16_t>> mStamps;
+    std::uint16_t mEpoch = 1;
+};
+
+#endif
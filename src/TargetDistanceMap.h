@@ -0,0 +1,152 @@
+#ifndef PCBROUTER_TARGET_DISTANCE_MAP_H
+#define PCBROUTER_TARGET_DISTANCE_MAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "GridAllocator.h"
+#include "point.h"
+
+// Lower bound of the cost still to pay to reach the targeted pin, apart from the wirelength, over
+// blocks of 2^shift x 2^shift cells per layer. A path pays at least the minimum base cost of every
+// block it enters, the layer change cost of every via and the layer preference cost of every step,
+// so a shortest path over the blocks with those weights never overestimates. Adding it to the
+// wirelength estimate keeps A* admissible. The block minima are kept up to date over many searches:
+// lowered as the base costs fall, and the blocks whose minimum rose scanned again before the next
+// build.
+class TargetDistanceMap {
+   public:
+    //ctor
+    TargetDistanceMap() {}
+    //dtor
+    ~TargetDistanceMap() {}
+
+    TargetDistanceMap(const TargetDistanceMap &) = delete;
+    TargetDistanceMap &operator=(const TargetDistanceMap &) = delete;
+
+    // For a w x h x l grid, the base costs are reset to be lowered by lowerBaseCost()
+    void setup(const int w, const int h, const int l, const int shift) {
+        assert(w > 0 && h > 0 && l > 0 && shift >= 0);
+        this->mShift = shift;
+        this->mW = ((w - 1) >> shift) + 1;
+        this->mH = ((h - 1) >> shift) + 1;
+        this->mL = l;
+        const int numBlocks = this->mW * this->mH * this->mL;
+        this->mBaseCost.assign(numBlocks, std::numeric_limits<float>::infinity());
+        this->mDistance.assign(numBlocks, 0.0);
+        this->mStale.assign(numBlocks, 0);
+        this->mStaleBlocks.clear();
+    }
+    void clear() {
+        this->mBaseCost.clear();
+        this->mDistance.clear();
+        this->mStale.clear();
+        this->mStaleBlocks.clear();
+    }
+
+    bool empty() const { return mBaseCost.empty(); }
+    std::size_t allocatedBytes() const {
+        return (this->mBaseCost.capacity() + this->mDistance.capacity()) * sizeof(float) + this->mStale.capacity() + this->mStaleBlocks.capacity() * sizeof(int);
+    }
+    int blockSize() const { return 1 << this->mShift; }
+    // Lowest x, y and layer of the cells of block id
+    inline Location blockOrigin(const int id) const {
+        return Location{(id % this->mW) << this->mShift, (id / this->mW % this->mH) << this->mShift, id / (this->mW * this->mH)};
+    }
+
+    inline int blockId(const Location &l) const { return (l.m_z * this->mH + (l.m_y >> this->mShift)) * this->mW + (l.m_x >> this->mShift); }
+    // Lowers the base cost of the block of l to the one of l, 0 at least
+    inline void lowerBaseCost(const Location &l, const float value) {
+        float &cost = this->mBaseCost[this->blockId(l)];
+        cost = std::min(cost, std::max(value, 0.0f));
+    }
+    // The base cost of l changed from oldValue to value. A block whose minimum may have risen is
+    // left low, a lower bound still, until scanned again.
+    inline void updateBaseCost(const Location &l, const float oldValue, const float value) {
+        const int id = this->blockId(l);
+        if (value < this->mBaseCost[id]) {
+            this->mBaseCost[id] = std::max(value, 0.0f);
+        } else if (value > oldValue && oldValue <= this->mBaseCost[id] && !this->mStale[id]) {
+            this->mStale[id] = 1;
+            this->mStaleBlocks.push_back(id);
+        }
+    }
+    // Blocks to reset by resetBlock() and lower by lowerBaseCost() again for their exact minima
+    const std::vector<int> &staleBlocks() const { return this->mStaleBlocks; }
+    inline void resetBlock(const int id) {
+        this->mBaseCost[id] = std::numeric_limits<float>::infinity();
+        this->mStale[id] = 0;
+    }
+    void clearStaleBlocks() { this->mStaleBlocks.clear(); }
+
+    // Shortest paths to the targets over the blocks, 8-connected on a layer. Planar moves pay the
+    // base cost of the block entered, vias pay layerChangeCost and connect adjacent layers only for
+    // micro vias. Both pay the preference cost of the layer entered, negative ones count as 0.
+    void build(const std::vector<Location> &targets, const double layerChangeCost, const std::vector<int> &layerCosts, const bool microVia) {
+        assert((int)layerCosts.size() >= this->mL);
+        typedef std::pair<float, int> Item;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+        std::fill(this->mDistance.begin(), this->mDistance.end(), std::numeric_limits<float>::infinity());
+        for (const auto &target : targets) {
+            const int id = this->blockId(target);
+            this->mDistance[id] = 0.0;
+            queue.push(Item(0.0, id));
+        }
+
+        // Relaxes the move from block id into block next, backwards from the targets
+        auto relax = [&](const int id, const int next, const float stepCost) {
+            const float cost = this->mDistance[id] + stepCost;
+            if (cost < this->mDistance[next]) {
+                this->mDistance[next] = cost;
+                queue.push(Item(cost, next));
+            }
+        };
+        while (!queue.empty()) {
+            const Item item = queue.top();
+            queue.pop();
+            const int id = item.second;
+            if (item.first > this->mDistance[id]) continue;
+
+            // A move from next into id pays id's entering cost
+            const int x = id % this->mW;
+            const int y = id / this->mW % this->mH;
+            const int z = id / (this->mW * this->mH);
+            const float layerCost = (float)std::max(layerCosts[z], 0);
+            const float planarCost = this->mBaseCost[id] + layerCost;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if ((dx == 0 && dy == 0) || x + dx < 0 || x + dx >= this->mW || y + dy < 0 || y + dy >= this->mH) continue;
+                    relax(id, id + dy * this->mW + dx, planarCost);
+                }
+            }
+            const float viaCost = (float)layerChangeCost + layerCost;
+            const int layerStride = this->mW * this->mH;
+            for (int nz = 0; nz < this->mL; ++nz) {
+                if (nz == z || (microVia && abs(nz - z) != 1)) continue;
+                relax(id, id + (nz - z) * layerStride, viaCost);
+            }
+        }
+    }
+
+    inline float at(const Location &l) const { return this->mDistance[this->blockId(l)]; }
+
+   private:
+    int mShift = 0;
+    int mW = 0;
+    int mH = 0;
+    int mL = 0;
+
+    std::vector<float, GridStdAllocator<float>> mBaseCost;  // Per block, minimum base cost of its cells, or lower
+    std::vector<float, GridStdAllocator<float>> mDistance;  // Per block
+    std::vector<std::uint8_t> mStale;                       // Per block, in mStaleBlocks
+    std::vector<int> mStaleBlocks;
+};
+
+#endif
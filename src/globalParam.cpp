@@ -2,7 +2,7 @@
 
 int GlobalParam::gLayerNum = 3;
 double GlobalParam::gEpsilon = 0.00000000000001;
-bool GlobalParam::g90DegreeMode = true;
+bool GlobalParam::g90DegreeMode = false;  // No diagonal (45-degree) steps in the search
 // BoardGrid
 double GlobalParam::gDiagonalCost = 1.41421356237;  //Cost for path searching
 double GlobalParam::gWirelengthCost = 1.0;          //Cost for path searching
@@ -22,10 +22,36 @@ double GlobalParam::gViaForbiddenCost = 2000.0;
 unsigned int GlobalParam::inputScale = 10;
 unsigned int GlobalParam::enlargeBoundary = 0;  //from 10 -> 50
 float GlobalParam::gridFactor = 0.1;            // 1/inputScale
+unsigned int GlobalParam::gGridTileSize = 0;    // 0: row-major, otherwise rounded up to a power of two (8, 16, ...)
+bool GlobalParam::gGridTileLayerInterleave = false;
+bool GlobalParam::gGridSparse = false;      // Uses 16x16 tiles if gGridTileSize is 0
+int GlobalParam::gSearchWindowMargin = -1;  // Grown automatically when no path is found in the window
+string GlobalParam::gGridMmapDirectory = "";  // Uses 16x16 tiles if gGridTileSize is 0, ignored by sparse grids
+bool GlobalParam::gGridHugePages = false;
+bool GlobalParam::gGridNumaInterleave = false;
+double GlobalParam::gMemoryBudgetMB = 0.0;  // inputScale is the finest scale tried
+double GlobalParam::gTimeBudget = 0.0;
 // Routing Options
 bool GlobalParam::gViaUnderPad = false;
 bool GlobalParam::gUseMircoVia = true;
+int GlobalParam::gPinOrder = 0;  // 0: DB order, 1: MST (Prim) order, 2: Steiner-aware MST order
+bool GlobalParam::gBendingAwareSearch = true;  // Bends are counted in the search cost
 unsigned int GlobalParam::gNumRipUpReRouteIteration = 5;
+bool GlobalParam::gBucketFrontier = false;
+double GlobalParam::gBucketFrontierResolution = 0.0625;  // Finer than gDiagonalCost - gWirelengthCost
+bool GlobalParam::gBucketFrontierQoRCheck = false;
+bool GlobalParam::gBidirectionalSearch = false;  // Exact frontier only, gBucketFrontier does not apply
+unsigned int GlobalParam::gTargetDistanceMapBlockSize = 0;  // Rounded up to a power of two (4, 8, ...)
+bool GlobalParam::gIncrementalSearch = false;               // Exact frontier only, gBucketFrontier does not apply
+double GlobalParam::gHeuristicWeight = 1.0;                 // Bidirectional searches stay unweighted
+unsigned int GlobalParam::gHeuristicWeightIterations = 0;
+double GlobalParam::gGlobalRoutingGCellSize = 0.0;  // 1.0 for 1 mm GCells
+unsigned int GlobalParam::gGlobalRoutingCorridorMargin = 1;
+unsigned int GlobalParam::gGlobalRoutingIterations = 5;
+bool GlobalParam::gJumpSearch = false;  // Not in bidirectional searches
+unsigned int GlobalParam::gSearchExpansionLimit = 0;  // The connection is left unrouted and its net flagged
+unsigned int GlobalParam::gNumLandmarks = 0;          // Tables rebuilt at each rip-up and re-route iteration, 8 is plenty
+unsigned int GlobalParam::gLandmarkBlockSize = 4;     // Rounded up to a power of two (4, 8, ...)
 // Outputfile
 int GlobalParam::gOutputPrecision = 5;
 string GlobalParam::gOutputFolder = "output";
@@ -52,10 +78,12 @@ void GlobalParam::setFolders() {
 
 void GlobalParam::showCurrentUsage(const string comment) {
     runTime.showUsage(comment, util::TimeUsage::PARTIAL);
+    util::showMemoryUsage();
 }
 
 void GlobalParam::showFinalUsage(const string comment) {
     runTime.showUsage(comment, util::TimeUsage::FULL);
+    util::showMemoryUsage();
 }
 
 void GlobalParam::setUsageStart() {
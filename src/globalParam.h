@@ -5,6 +5,9 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <string>
 
 #include "util.h"
@@ -20,13 +23,44 @@ namespace pr {
 using prIntCost = int;
 using prFltCost = double;
 
+// Cost of the searches (working costs, frontier keys) and of the base cost updates. Fixed point
+// costs add exactly and in any order, so the routes are the same for every compiler and the
+// frontiers compare integers. Conversions round to the nearest unit and saturate at kCostInfinity.
+#ifdef PCBROUTER_FIXED_POINT_COST
+using prCost = std::int32_t;
+const int kCostFractionBits = 6;  // Units of 1/64: gDiagonalCost is 91 units, 0.5% above sqrt(2)
+const prCost kCostInfinity = (1 << 30) - 1;  // Unreached, two costs add up without overflow
+inline prCost toCost(const double value) {
+    const double units = value * (1 << kCostFractionBits);
+    if (units >= kCostInfinity) return kCostInfinity;
+    if (units <= -kCostInfinity) return -kCostInfinity;
+    return (prCost)std::lrint(units);  // To nearest, ties to even
+}
+inline double fromCost(const prCost value) { return value * (1.0 / (1 << kCostFractionBits)); }
+inline prCost addCost(const prCost a, const prCost b) { return std::max(std::min(a + b, kCostInfinity), -kCostInfinity); }
+#else
+using prCost = float;
+const prCost kCostInfinity = std::numeric_limits<float>::infinity();
+inline prCost toCost(const double value) { return value; }
+inline double fromCost(const prCost value) { return value; }
+inline prCost addCost(const prCost a, const prCost b) { return a + b; }
+#endif
+
+#ifdef PCBROUTER_QUANTIZED_COST
+using prStoredCost = std::int16_t;  // Fixed point in units of BoardGrid's cost quantum
+#elif defined(PCBROUTER_FIXED_POINT_COST)
+using prStoredCost = prCost;
+#else
+using prStoredCost = float;
+#endif
+
 }  // namespace pr
 
 class GlobalParam {
    public:
     static int gLayerNum;
     static double gEpsilon;
-    static bool g90DegreeMode;
+    static bool g90DegreeMode;  // Manhattan routing, the search takes no diagonal steps
 
     //BoardGrid
     static double gDiagonalCost;
@@ -51,11 +85,37 @@ class GlobalParam {
     static unsigned int inputScale;
     static unsigned int enlargeBoundary;
     static float gridFactor;  // For outputing
+    static unsigned int gGridTileSize;     // Edge of the xy tiles in BoardGrid cell addressing, 0 for row-major
+    static bool gGridTileLayerInterleave;  // Store all layers of a tile next to each other
+    static bool gGridSparse;               // Allocate BoardGrid tiles on first write
+    static int gSearchWindowMargin;        // Margin (in grids) of the A* search window, -1 for the whole board
+    static string gGridMmapDirectory;      // Back the BoardGrid planes by files in this directory, empty for the heap
+    static bool gGridHugePages;            // Huge pages for large grid planes and search buffers
+    static bool gGridNumaInterleave;       // Interleave large grid planes and search buffers over the NUMA nodes
+    static double gMemoryBudgetMB;         // Lower inputScale until the estimated memory fits, 0 for no budget
+    static double gTimeBudget;             // Lower inputScale until the estimated routing time (s) fits, 0 for no budget
 
     //Routing Options
     static bool gViaUnderPad;
     static bool gUseMircoVia;
+    static int gPinOrder;             // PinOrder of the connections of multi-pin nets
+    static bool gBendingAwareSearch;  // Bending cost and estimate in the search, off for a plain wirelength search
     static unsigned int gNumRipUpReRouteIteration;
+    static bool gBucketFrontier;                       // Radix bucket queue over quantized keys as the A* open list
+    static double gBucketFrontierResolution;           // Key quantum of the bucket queue
+    static bool gBucketFrontierQoRCheck;               // Rerun each bucket queue search with exact ordering, report the cost difference
+    static bool gBidirectionalSearch;                  // Pin to pin connections search from both pins, meeting in the middle
+    static unsigned int gTargetDistanceMapBlockSize;   // Cells per side of the blocks of the A* target distance map, 0 for none
+    static bool gIncrementalSearch;                    // Each connection of a net resumes the search of the previous one
+    static double gHeuristicWeight;                    // Weighted A* in the first routing pass, 1 for admissible searches
+    static unsigned int gHeuristicWeightIterations;    // Rip-up and re-route iterations to tighten gHeuristicWeight to 1 over, 0 to keep it
+    static double gGlobalRoutingGCellSize;             // GCell edge (mm) of the global routing, 0 for detailed routing only
+    static unsigned int gGlobalRoutingCorridorMargin;  // GCells around the global route a detailed search may expand
+    static unsigned int gGlobalRoutingIterations;      // Rip-up and re-route iterations of the global routing
+    static bool gJumpSearch;                           // Planar moves jump over the cells of zero cost around
+    static unsigned int gSearchExpansionLimit;         // Cells a connection's searches may expand before giving up, 0 for no limit
+    static unsigned int gNumLandmarks;                 // Landmarks of the ALT lower bounds in the A* estimate, 0 for none
+    static unsigned int gLandmarkBlockSize;            // Cells per side of the blocks of the landmark distance tables
 
     //Outputfile
     static int gOutputPrecision;
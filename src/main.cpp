@@ -62,6 +62,9 @@ int main(int argc, char *argv[]) {
     if (argc >= 9) {
         router.set_via_obstacle_step_size(atof(argv[8]));
     }
+    if (argc >= 10) {
+        router.set_grid_tile_size(atoi(argv[9]));
+    }
     // router.testRouterWithPinShape();
     router.initialization();
     // GND (20) to route on Bottom Layer
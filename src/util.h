@@ -152,16 +152,35 @@ class TimeUsage {
     TimeState tStart_, pStart_;  //total, period
 };
 // memory
-inline double getPeakMemoryUsage() {
+struct MemoryUsage {
+    double peakResident = -1;  // MB
+    double resident = -1;      // MB, includes residentFile
+    double residentFile = -1;  // MB, resident pages of file mappings (page cache)
+    double mapped = -1;        // MB, whole address space
+};
+inline MemoryUsage getMemoryUsage() {
+    MemoryUsage usage;
 #ifdef __linux__
-    char buf[1000];
-    ifstream ifs("/proc/self/stat");
-    for (int i = 0; i != 23; ++i)
-        ifs >> buf;
-    return (1.0 / (MEMORY_SCALE * MEMORY_SCALE) * atof(buf));  // GB
-#else
-    return -1;
+    ifstream ifs("/proc/self/status");
+    string key;
+    double kB = 0;
+    while (ifs >> key) {
+        if (key == "VmHWM:" && ifs >> kB) usage.peakResident = kB / MEMORY_SCALE;
+        if (key == "VmRSS:" && ifs >> kB) usage.resident = kB / MEMORY_SCALE;
+        if (key == "RssFile:" && ifs >> kB) usage.residentFile = kB / MEMORY_SCALE;
+        if (key == "VmSize:" && ifs >> kB) usage.mapped = kB / MEMORY_SCALE;
+    }
 #endif
+    return usage;
+}
+inline double getPeakMemoryUsage() {
+    return getMemoryUsage().peakResident;  // MB
+}
+inline void showMemoryUsage() {
+    MemoryUsage usage = getMemoryUsage();
+    cout << " Memory: Peak Resident:" << usage.peakResident << "MB; Resident:" << usage.resident
+         << "MB (file-backed:" << usage.residentFile << "MB); Mapped:" << usage.mapped << "MB." << endl
+         << endl;
 }
 
 // =====================================================